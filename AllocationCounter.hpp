@@ -0,0 +1,57 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdlib>
+#include <new>
+#ifdef _WIN32
+#include <malloc.h>
+#endif
+
+// --- Allocation Counter ---
+// Counts every call to the global operator new, plain and over-aligned (as
+// used for alignas(64) types), so tools can check that a tick did not touch
+// the heap. The replacement operators may only be defined
+// once per program: define ALLOCATION_COUNTER_IMPLEMENTATION before including
+// this header in exactly one translation unit.
+std::size_t allocationCount();
+
+#ifdef ALLOCATION_COUNTER_IMPLEMENTATION
+static std::atomic<std::size_t> allocationCounter{0};
+
+std::size_t allocationCount() { return allocationCounter.load(std::memory_order_relaxed); }
+
+void* operator new(std::size_t size) {
+    allocationCounter.fetch_add(1, std::memory_order_relaxed);
+    if (void* p = std::malloc(size ? size : 1)) return p;
+    throw std::bad_alloc();
+}
+void* operator new(std::size_t size, std::align_val_t align) {
+    allocationCounter.fetch_add(1, std::memory_order_relaxed);
+    std::size_t a = static_cast<std::size_t>(align);
+    std::size_t rounded = (std::max<std::size_t>(size, 1) + a - 1) / a * a;
+#ifdef _WIN32
+    if (void* p = _aligned_malloc(rounded, a)) return p;
+#else
+    if (void* p = std::aligned_alloc(a, rounded)) return p;
+#endif
+    throw std::bad_alloc();
+}
+// GCC pairs inlined library news with these frees and misreports a mismatch.
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wmismatched-new-delete"
+#endif
+void operator delete(void* p) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t) noexcept { std::free(p); }
+#ifdef _WIN32
+void operator delete(void* p, std::align_val_t) noexcept { _aligned_free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { _aligned_free(p); }
+#else
+void operator delete(void* p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void* p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+#endif
+#if defined(__GNUC__) && !defined(__clang__)
+#pragma GCC diagnostic pop
+#endif
+#endif
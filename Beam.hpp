@@ -0,0 +1,78 @@
+#pragma once
+#include "GameMath.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// --- Beams ---
+// A beam is a rotating line segment: it starts `from` px out along `angle`
+// and ends `to` px out, is 2 * radius thick, and turns `sweep` degrees per
+// tick. For its first `warmup` ticks it is only a warning and cannot hit.
+// A negative life keeps it until the pattern that fired it stops.
+//
+// The player test is an exact capsule (the segment swept by a circle of
+// `radius`), and the renderer draws each beam as a single quad.
+struct Beam {
+    sf::Vector2f origin;
+    float angle = 0.f, sweep = 0.f; // degrees, degrees per tick
+    float from = 0.f, to = 0.f;
+    float radius = 1.f;
+    int warmup = 0, life = -1, age = 0; // ticks
+    sf::Color color = sf::Color::White;
+    std::uint8_t emitter = 0;   // index of the emitter that fired it
+    bool followBoss = false;    // origin tracks the boss every tick
+
+    bool active() const { return age >= warmup; }
+    sf::Vector2f direction() const {
+        float rad = angle * (PI / 180.f);
+        return {std::cos(rad), std::sin(rad)};
+    }
+    sf::Vector2f start() const { return origin + direction() * from; }
+    sf::Vector2f end() const { return origin + direction() * to; }
+};
+
+// Fixed-capacity list of live beams; adding past capacity drops the beam.
+class BeamPool {
+public:
+    static constexpr std::size_t kDefaultCapacity = 64;
+
+    explicit BeamPool(std::size_t capacity = kDefaultCapacity) { beams.reserve(capacity); }
+
+    std::size_t size() const { return beams.size(); }
+    std::size_t capacity() const { return beams.capacity(); }
+    bool empty() const { return beams.empty(); }
+    void clear() { beams.clear(); }
+
+    const Beam& operator[](std::size_t i) const { return beams[i]; }
+    const Beam* begin() const { return beams.data(); }
+    const Beam* end() const { return beams.data() + beams.size(); }
+
+    bool add(const Beam& b) {
+        if (beams.size() == beams.capacity()) return false;
+        beams.push_back(b);
+        return true;
+    }
+
+    // Drops the beams an emitter fired earlier, before it fires again.
+    void removeEmitter(std::uint8_t emitter) {
+        beams.erase(std::remove_if(beams.begin(), beams.end(), [emitter](const Beam& b) { return b.emitter == emitter; }), beams.end());
+    }
+
+    // One tick: turn, age and expire every beam. Order is kept, so the
+    // result is the same however the beams were added.
+    void update(sf::Vector2f bossPos) {
+        for (Beam& b : beams) {
+            if (b.followBoss) b.origin = bossPos;
+            b.angle += b.sweep;
+            ++b.age;
+        }
+        beams.erase(std::remove_if(beams.begin(), beams.end(), [](const Beam& b) { return b.life >= 0 && b.age >= b.life; }), beams.end());
+    }
+
+private:
+    std::vector<Beam> beams;
+};
@@ -0,0 +1,164 @@
+#pragma once
+#include "Replay.hpp"
+#include "World.hpp"
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// --- Bots ---
+// A bot plays the player's side of a fight: once per tick, before
+// World::step(), it reads the World and returns that tick's input. Bots
+// only look at the World, so a seed and a bot still fully determine a run.
+// The aim point is quantized like recorded input, so any bot's fight can be
+// recorded and replayed.
+class BotPolicy {
+public:
+    virtual ~BotPolicy() = default;
+    virtual InputFrame next(const World& world, long tick) = 0;
+};
+
+// Circles the arena, strafes every half second, keeps firing at the boss and
+// uses the shotgun whenever it is close. Never dodges: the fixed workload
+// behind headless's determinism and allocation checks.
+class CircleBot : public BotPolicy {
+public:
+    InputFrame next(const World& world, long tick) override {
+        InputFrame in;
+        int leg = static_cast<int>(tick / world.ticks(0.5f)) % 4;
+        in.up = leg == 0;
+        in.right = leg == 1;
+        in.down = leg == 2;
+        in.left = leg == 3;
+        in.fire = true;
+        in.aim = quantizeAim(world.bossPos);
+        sf::Vector2f d = world.bossPos - world.playerPos;
+        in.shotgun = d.x * d.x + d.y * d.y < 250.f * 250.f;
+        return in;
+    }
+};
+
+// Dodges. Every reaction interval it tries standing still and each of the
+// eight directions, projects itself and every nearby bullet and beam along
+// their current motion over a short lookahead, and keeps the move with the
+// least overlap, with a pull towards a firing spot below the boss and away
+// from walls and the knife-wall void. Always fires at the boss; uses the
+// shotgun in range.
+class DodgeBot : public BotPolicy {
+public:
+    struct Params {
+        float reaction = 1.f / 30.f; // seconds between decisions
+        float lookahead = 0.2f;      // seconds projected ahead
+        float margin = 6.f;          // px of clearance wanted around the hitbox
+        float standoff = 280.f;      // px below the boss it likes to fight from
+    };
+
+    DodgeBot() = default;
+    explicit DodgeBot(const Params& params) : params(params) {}
+
+    InputFrame next(const World& world, long tick) override {
+        if (tick == 0 || tick >= nextDecision) {
+            move = choose(world);
+            nextDecision = tick + world.ticks(params.reaction);
+        }
+        InputFrame in;
+        in.up = move % 3 == 1;
+        in.down = move % 3 == 2;
+        in.left = move / 3 == 1;
+        in.right = move / 3 == 2;
+        in.fire = true;
+        in.aim = quantizeAim(world.bossPos);
+        sf::Vector2f d = world.bossPos - world.playerPos;
+        in.shotgun = d.x * d.x + d.y * d.y < 250.f * 250.f;
+        return in;
+    }
+
+private:
+    // Moves are numbered vertical + 3 * horizontal, each 0 (none), 1 (up or
+    // left) or 2 (down or right); 0 stands still.
+    int choose(const World& world) {
+        const float step = 500.f * world.tickDt;
+        const int reaction = world.ticks(params.reaction);
+        const int horizons[] = {reaction, 2 * reaction, 4 * reaction, world.ticks(params.lookahead)};
+        const float reachMax = horizons[3] * step * 1.5f + 60.f;
+        const sf::Vector2f p = world.playerPos;
+        const BulletPool& b = world.bullets;
+
+        nearby.clear();
+        nearby.reserve(b.capacity());
+        for (std::size_t i = 0; i < b.size(); ++i) {
+            float dx = b.x[i] - p.x, dy = b.y[i] - p.y;
+            float travel = std::sqrt(b.vx[i] * b.vx[i] + b.vy[i] * b.vy[i]) * horizons[3];
+            float reach = reachMax + travel + b.radius[i] * std::max(b.scaleX[i], b.scaleY[i]);
+            if (dx * dx + dy * dy < reach * reach) nearby.push_back(static_cast<std::uint32_t>(i));
+        }
+
+        float left = World::playerRadius + params.margin, right = World::worldW - left;
+        if (world.voidActive()) {
+            left = std::max(left, world.voidLeft + World::playerRadius + 4.f * params.margin);
+            right = std::min(right, world.voidRight - World::playerRadius - 4.f * params.margin);
+        }
+        sf::Vector2f home{std::clamp(world.bossPos.x, left, right), std::min(world.bossPos.y + params.standoff, World::worldH - 80.f)};
+
+        int best = 0;
+        float bestCost = 0.f;
+        for (int m = 0; m < 9; ++m) {
+            sf::Vector2f v{m / 3 == 1 ? -step : m / 3 == 2 ? step : 0.f, m % 3 == 1 ? -step : m % 3 == 2 ? step : 0.f};
+            float cost = 0.f;
+            for (int h : horizons) {
+                sf::Vector2f q{std::clamp(p.x + v.x * h, World::playerRadius, World::worldW - World::playerRadius),
+                               std::clamp(p.y + v.y * h, World::playerRadius, World::worldH - World::playerRadius)};
+                float weight = static_cast<float>(reaction) / h;
+                cost += weight * threat(world, q, h);
+                if (q.x < left || q.x > right) cost += weight * 50.f;
+            }
+            sf::Vector2f end = p + v * static_cast<float>(horizons[3]);
+            sf::Vector2f toHome = home - end;
+            cost += 0.002f * std::sqrt(toHome.x * toHome.x + toHome.y * toHome.y);
+            float edge = std::min({end.x, World::worldW - end.x, end.y, World::worldH - end.y});
+            if (edge < 80.f) cost += 0.01f * (80.f - edge);
+            if (m == 0 || cost < bestCost) {
+                best = m;
+                bestCost = cost;
+            }
+        }
+        return best;
+    }
+
+    // Summed depth of overlap, as a fraction of each reach, between the
+    // player at q and every nearby bullet and live beam h ticks from now.
+    float threat(const World& world, sf::Vector2f q, int h) const {
+        const BulletPool& b = world.bullets;
+        float sum = 0.f;
+        for (std::uint32_t i : nearby) {
+            float dx = b.x[i] + b.vx[i] * h - q.x, dy = b.y[i] + b.vy[i] * h - q.y;
+            float reach = b.radius[i] * std::max(b.scaleX[i], b.scaleY[i]) + World::playerRadius + params.margin;
+            float d2 = dx * dx + dy * dy;
+            if (d2 < reach * reach) sum += 1.f - std::sqrt(d2) / reach;
+        }
+        for (const Beam& beam : world.beams) {
+            if (beam.age + h < beam.warmup) continue;
+            Beam future = beam;
+            future.angle += beam.sweep * h;
+            if (capsuleCircle(future.start(), future.end(), beam.radius + params.margin, q, World::playerRadius)) sum += 1.f;
+        }
+        return sum;
+    }
+
+    Params params;
+    long nextDecision = 0;
+    int move = 0;
+    std::vector<std::uint32_t> nearby;
+};
+
+inline constexpr const char* kBotNames[] = {"circle", "dodge"};
+
+// nullptr for an unknown name.
+inline std::unique_ptr<BotPolicy> makeBot(const std::string& name) {
+    if (name == "circle") return std::make_unique<CircleBot>();
+    if (name == "dodge") return std::make_unique<DodgeBot>();
+    return nullptr;
+}
@@ -0,0 +1,84 @@
+#pragma once
+#include "Beam.hpp"
+#include "BulletPool.hpp"
+#include <SFML/Graphics/Vertex.hpp>
+#include <cmath>
+#include <vector>
+
+// One bullet as the renderer needs it: where it was last tick and where it
+// is now, its half extents and its colour.
+struct BulletSprite {
+    sf::Vector2f prev, pos;
+    sf::Vector2f halfSize;
+    sf::Color color;
+
+    // Bullets born this tick without moving yet are drawn where they are.
+    static void appendPool(std::vector<BulletSprite>& out, const BulletPool& pool) {
+        for (std::size_t i = 0; i < pool.size(); ++i) {
+            sf::Vector2f p = pool.position(i);
+            sf::Vector2f prev = pool.aliveTime[i] > 0.f ? p - sf::Vector2f(pool.vx[i], pool.vy[i]) : p;
+            out.push_back({prev, p, {pool.radius[i] * pool.scaleX[i], pool.radius[i] * pool.scaleY[i]}, pool.color[i]});
+        }
+    }
+};
+
+// --- Bullet Batch ---
+// Every projectile becomes one textured quad (two triangles) sampling a
+// white circle, tinted through the vertex colour. A beam is one quad too,
+// stretched along the circle's middle column so only its sides fade.
+// Building the batch needs only sf::Vertex, no window or GL context, so
+// bench times it headless.
+struct BulletBatch {
+    static constexpr float kTextureSize = 64.f;
+
+    std::vector<sf::Vertex> vertices;
+
+    void clear() { vertices.clear(); }
+    std::size_t quadCount() const { return vertices.size() / 6; }
+
+    void addCircle(sf::Vector2f center, float radius, sf::Vector2f scale, sf::Color color) {
+        float hw = radius * scale.x, hh = radius * scale.y;
+        sf::Vertex tl{{center.x - hw, center.y - hh}, color, {0.f, 0.f}};
+        sf::Vertex tr{{center.x + hw, center.y - hh}, color, {kTextureSize, 0.f}};
+        sf::Vertex br{{center.x + hw, center.y + hh}, color, {kTextureSize, kTextureSize}};
+        sf::Vertex bl{{center.x - hw, center.y + hh}, color, {0.f, kTextureSize}};
+        vertices.insert(vertices.end(), {tl, tr, br, tl, br, bl});
+    }
+
+    // A beam still warming up is drawn as a thin, faint guide line.
+    void addBeams(const BeamPool& beams, float alpha = 1.f) {
+        vertices.reserve(vertices.size() + beams.size() * 6);
+        float mid = kTextureSize / 2.f;
+        for (const Beam& b : beams) {
+            float rad = (b.angle - b.sweep * (1.f - alpha)) * (PI / 180.f);
+            sf::Vector2f dir{std::cos(rad), std::sin(rad)};
+            sf::Vector2f side = sf::Vector2f(-dir.y, dir.x) * (b.active() ? b.radius : b.radius * 0.3f);
+            sf::Vector2f a = b.origin + dir * b.from, e = b.origin + dir * b.to;
+            sf::Color c = b.color;
+            if (!b.active()) c.a = 90;
+            sf::Vertex tl{a - side, c, {mid, 0.f}};
+            sf::Vertex tr{e - side, c, {mid, 0.f}};
+            sf::Vertex br{e + side, c, {mid, kTextureSize}};
+            sf::Vertex bl{a + side, c, {mid, kTextureSize}};
+            vertices.insert(vertices.end(), {tl, tr, br, tl, br, bl});
+        }
+    }
+
+    // alpha in [0, 1] places each bullet between its previous and current
+    // tick.
+    void addSprites(const std::vector<BulletSprite>& sprites, float alpha = 1.f) {
+        vertices.reserve(vertices.size() + sprites.size() * 6);
+        for (const BulletSprite& b : sprites) addCircle(b.prev + (b.pos - b.prev) * alpha, 1.f, b.halfSize, b.color);
+    }
+
+    // The frame governor's cheap path: tick positions, no interpolation,
+    // and only sprites overlapping [min, max].
+    void addVisibleSprites(const std::vector<BulletSprite>& sprites, sf::Vector2f min, sf::Vector2f max) {
+        vertices.reserve(vertices.size() + sprites.size() * 6);
+        for (const BulletSprite& b : sprites) {
+            if (b.pos.x + b.halfSize.x < min.x || b.pos.x - b.halfSize.x > max.x ||
+                b.pos.y + b.halfSize.y < min.y || b.pos.y - b.halfSize.y > max.y) continue;
+            addCircle(b.pos, 1.f, b.halfSize, b.color);
+        }
+    }
+};
@@ -0,0 +1,324 @@
+#pragma once
+#include "BulletPool.hpp"
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+
+#if (defined(__x86_64__) || defined(__i386__)) && defined(__GNUC__)
+#define BULLET_KERNEL_X86 1
+#include <immintrin.h>
+#endif
+
+// --- Bullet Kernel ---
+// Moves and ages every enemy bullet and sorts it into one of four outcomes,
+// eight bullets per block, one bit per bullet:
+//   exploded - a poprock past its burst range
+//   expired  - lifetime over, a phase 3 shot past its range, or out of bounds
+//   hit      - still in play and overlapping the player at some point of
+//              the tick, both moving in straight lines
+//   expired  - (again) not a poprock, did not hit, and wholly past the shed
+//              box moving away; shedding never takes a hit away
+//   alive    - none of the above
+// The outcomes are exclusive and checked in that order. Every ISA does the
+// same single-precision operations in the same order (no FMA), so the SSE2
+// and AVX2 paths match the scalar one bit for bit.
+
+struct KernelParams {
+    float minX, minY, maxX, maxY;   // bullets outside this box are expired
+    float burstRange2;              // squared poprock detonation distance
+    float phase3Range2;             // squared phase 3 shot range
+    float playerX, playerY, playerRadius;
+    float playerDX = 0.f, playerDY = 0.f; // how far the player moved this tick
+    // Off-screen shedding; infinite (the default) turns it off.
+    float shedMinX = -INFINITY, shedMinY = -INFINITY, shedMaxX = INFINITY, shedMaxY = INFINITY;
+};
+
+struct BulletMasks {
+    std::vector<std::uint8_t> alive, expired, exploded, hit;
+    std::size_t blocks = 0;
+
+    static std::size_t blockCount(std::size_t n) { return (n + 7) / 8; }
+
+    // Sizes the masks for n bullets up front, so resize() up to n is free.
+    void reserve(std::size_t n) {
+        std::size_t b = blockCount(n);
+        if (alive.size() < b) {
+            alive.resize(b); expired.resize(b);
+            exploded.resize(b); hit.resize(b);
+        }
+    }
+
+    void resize(std::size_t n) {
+        reserve(n);
+        blocks = blockCount(n);
+    }
+};
+
+enum class KernelIsa { Scalar, SSE2, AVX2 };
+
+inline const char* kernelIsaName(KernelIsa isa) {
+    switch (isa) {
+        case KernelIsa::AVX2: return "avx2";
+        case KernelIsa::SSE2: return "sse2";
+        default: return "scalar";
+    }
+}
+
+namespace bullet_kernel {
+
+// One bullet; also finishes the partial last block of the SIMD paths.
+inline void step(BulletPool& pool, std::size_t i, const KernelParams& p, BulletMasks& m) {
+    float x = pool.x[i] += pool.vx[i];
+    float y = pool.y[i] += pool.vy[i];
+    float age = pool.aliveTime[i] += 1.f;
+    float dx = x - pool.startX[i], dy = y - pool.startY[i];
+    float d2 = dx * dx + dy * dy;
+    std::uint8_t f = pool.flags[i];
+
+    bool exploded = (f & BulletPool::Poprock) && d2 > p.burstRange2;
+    bool expired = !exploded && ((pool.lifeTime[i] > 0.f && age >= pool.lifeTime[i]) ||
+                                 ((f & BulletPool::Phase3Shot) && d2 > p.phase3Range2) ||
+                                 x < p.minX || x > p.maxX || y < p.minY || y > p.maxY);
+    float r = pool.radius[i];
+    float extent = r * std::max(pool.scaleX[i], pool.scaleY[i]);
+    float vx = pool.vx[i], vy = pool.vy[i];
+    bool shed = !(f & BulletPool::Poprock) &&
+                ((x + extent < p.shedMinX && vx <= 0.f) || (x - extent > p.shedMaxX && vx >= 0.f) ||
+                 (y + extent < p.shedMinY && vy <= 0.f) || (y - extent > p.shedMaxY && vy >= 0.f));
+    // Same test as ellipseCircle(), swept: in coordinates scaled by the
+    // summed axes the player's offset from the bullet runs from n - w at the
+    // start of the tick to n at its end, and comes closest to the bullet at
+    // n - s w, s = n.w / w.w. It hits if either end is inside the unit
+    // circle, or the closest point lies between them and inside, which
+    // |n|^2 - (n.w)^2 / w.w < 1 says without dividing. None of that can hold
+    // unless |n| < 1 + |w|, so the SIMD paths skip it for a block with no
+    // lane under the looser |n|^2 < 4 (1 + |w|^2).
+    float rx = 1.f / (r * pool.scaleX[i] + p.playerRadius), ry = 1.f / (r * pool.scaleY[i] + p.playerRadius);
+    float nx = (p.playerX - x) * rx, ny = (p.playerY - y) * ry;
+    float wx = (p.playerDX - vx) * rx, wy = (p.playerDY - vy) * ry;
+    float n2 = nx * nx + ny * ny, w2 = wx * wx + wy * wy, nw = nx * wx + ny * wy;
+    float sx0 = nx - wx, sy0 = ny - wy;
+    bool touch = n2 < 1.f || sx0 * sx0 + sy0 * sy0 < 1.f || (nw > 0.f && nw < w2 && (n2 - 1.f) * w2 < nw * nw);
+    bool hit = !exploded && !expired && touch;
+    expired = expired || (!exploded && !hit && shed);
+
+    std::size_t b = i / 8;
+    std::uint8_t bit = static_cast<std::uint8_t>(1u << (i % 8));
+    if (exploded) m.exploded[b] |= bit;
+    else if (expired) m.expired[b] |= bit;
+    else if (hit) m.hit[b] |= bit;
+    else m.alive[b] |= bit;
+}
+
+inline void clearMasks(BulletMasks& m, std::size_t first, std::size_t last) {
+    for (std::size_t b = first; b < last; ++b) m.alive[b] = m.expired[b] = m.exploded[b] = m.hit[b] = 0;
+}
+
+// Processes blocks [firstBlock, lastBlock) of a pool holding n bullets.
+inline void runScalar(BulletPool& pool, std::size_t n, std::size_t firstBlock, std::size_t lastBlock,
+                      const KernelParams& p, BulletMasks& m) {
+    clearMasks(m, firstBlock, lastBlock);
+    std::size_t end = std::min(n, lastBlock * 8);
+    for (std::size_t i = firstBlock * 8; i < end; ++i) step(pool, i, p, m);
+}
+
+#ifdef BULLET_KERNEL_X86
+// Four lanes of the block at i; returns the exploded/expired/hit/alive lane
+// masks in bits 0-3 of each output.
+__attribute__((target("sse2")))
+inline void sse2Lanes(BulletPool& pool, std::size_t i, const KernelParams& p,
+                      int& exploded, int& expired, int& hit, int& alive) {
+    __m128 vx = _mm_loadu_ps(&pool.vx[i]), vy = _mm_loadu_ps(&pool.vy[i]);
+    __m128 x = _mm_add_ps(_mm_loadu_ps(&pool.x[i]), vx);
+    __m128 y = _mm_add_ps(_mm_loadu_ps(&pool.y[i]), vy);
+    __m128 age = _mm_add_ps(_mm_loadu_ps(&pool.aliveTime[i]), _mm_set1_ps(1.f));
+    _mm_storeu_ps(&pool.x[i], x);
+    _mm_storeu_ps(&pool.y[i], y);
+    _mm_storeu_ps(&pool.aliveTime[i], age);
+
+    __m128 dx = _mm_sub_ps(x, _mm_loadu_ps(&pool.startX[i]));
+    __m128 dy = _mm_sub_ps(y, _mm_loadu_ps(&pool.startY[i]));
+    __m128 d2 = _mm_add_ps(_mm_mul_ps(dx, dx), _mm_mul_ps(dy, dy));
+
+    std::uint32_t bytes;
+    std::memcpy(&bytes, &pool.flags[i], 4);
+    __m128i zero = _mm_setzero_si128();
+    __m128i f = _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int>(bytes)), zero), zero);
+    __m128i pop = _mm_set1_epi32(BulletPool::Poprock), p3 = _mm_set1_epi32(BulletPool::Phase3Shot);
+    __m128 isPoprock = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(f, pop), pop));
+    __m128 isPhase3 = _mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(f, p3), p3));
+
+    __m128 boom = _mm_and_ps(isPoprock, _mm_cmpgt_ps(d2, _mm_set1_ps(p.burstRange2)));
+    __m128 life = _mm_loadu_ps(&pool.lifeTime[i]);
+    __m128 gone = _mm_and_ps(_mm_cmpgt_ps(life, _mm_setzero_ps()), _mm_cmpge_ps(age, life));
+    gone = _mm_or_ps(gone, _mm_and_ps(isPhase3, _mm_cmpgt_ps(d2, _mm_set1_ps(p.phase3Range2))));
+    gone = _mm_or_ps(gone, _mm_or_ps(_mm_cmplt_ps(x, _mm_set1_ps(p.minX)), _mm_cmpgt_ps(x, _mm_set1_ps(p.maxX))));
+    gone = _mm_or_ps(gone, _mm_or_ps(_mm_cmplt_ps(y, _mm_set1_ps(p.minY)), _mm_cmpgt_ps(y, _mm_set1_ps(p.maxY))));
+
+    __m128 r = _mm_loadu_ps(&pool.radius[i]);
+    __m128 sx = _mm_loadu_ps(&pool.scaleX[i]), sy = _mm_loadu_ps(&pool.scaleY[i]);
+    __m128 extent = _mm_mul_ps(r, _mm_max_ps(sx, sy)), z = _mm_setzero_ps();
+    __m128 shed = _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(_mm_add_ps(x, extent), _mm_set1_ps(p.shedMinX)), _mm_cmple_ps(vx, z)),
+                            _mm_and_ps(_mm_cmpgt_ps(_mm_sub_ps(x, extent), _mm_set1_ps(p.shedMaxX)), _mm_cmpge_ps(vx, z)));
+    shed = _mm_or_ps(shed, _mm_or_ps(_mm_and_ps(_mm_cmplt_ps(_mm_add_ps(y, extent), _mm_set1_ps(p.shedMinY)), _mm_cmple_ps(vy, z)),
+                                     _mm_and_ps(_mm_cmpgt_ps(_mm_sub_ps(y, extent), _mm_set1_ps(p.shedMaxY)), _mm_cmpge_ps(vy, z))));
+    shed = _mm_andnot_ps(isPoprock, shed);
+    gone = _mm_andnot_ps(boom, gone);
+
+    __m128 pr = _mm_set1_ps(p.playerRadius), one = _mm_set1_ps(1.f);
+    __m128 rx = _mm_div_ps(one, _mm_add_ps(_mm_mul_ps(r, sx), pr)), ry = _mm_div_ps(one, _mm_add_ps(_mm_mul_ps(r, sy), pr));
+    __m128 nx = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(p.playerX), x), rx), ny = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(p.playerY), y), ry);
+    __m128 wx = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(p.playerDX), vx), rx), wy = _mm_mul_ps(_mm_sub_ps(_mm_set1_ps(p.playerDY), vy), ry);
+    __m128 n2 = _mm_add_ps(_mm_mul_ps(nx, nx), _mm_mul_ps(ny, ny));
+    __m128 w2 = _mm_add_ps(_mm_mul_ps(wx, wx), _mm_mul_ps(wy, wy));
+    __m128 touch = _mm_cmplt_ps(n2, one);
+    if (_mm_movemask_ps(_mm_cmplt_ps(n2, _mm_mul_ps(_mm_set1_ps(4.f), _mm_add_ps(one, w2))))) { // else too far to touch
+        __m128 nw = _mm_add_ps(_mm_mul_ps(nx, wx), _mm_mul_ps(ny, wy));
+        __m128 sx0 = _mm_sub_ps(nx, wx), sy0 = _mm_sub_ps(ny, wy);
+        touch = _mm_or_ps(touch, _mm_cmplt_ps(_mm_add_ps(_mm_mul_ps(sx0, sx0), _mm_mul_ps(sy0, sy0)), one));
+        __m128 between = _mm_and_ps(_mm_cmpgt_ps(nw, z), _mm_cmplt_ps(nw, w2));
+        touch = _mm_or_ps(touch, _mm_and_ps(between, _mm_cmplt_ps(_mm_mul_ps(_mm_sub_ps(n2, one), w2), _mm_mul_ps(nw, nw))));
+    }
+    __m128 removed = _mm_or_ps(boom, gone);
+    touch = _mm_andnot_ps(removed, touch);
+    gone = _mm_or_ps(gone, _mm_andnot_ps(_mm_or_ps(boom, touch), shed));
+
+    exploded = _mm_movemask_ps(boom);
+    expired = _mm_movemask_ps(gone);
+    hit = _mm_movemask_ps(touch);
+    alive = ~(exploded | expired | hit) & 0xF;
+}
+
+__attribute__((target("sse2")))
+inline void runSSE2(BulletPool& pool, std::size_t n, std::size_t firstBlock, std::size_t lastBlock,
+                    const KernelParams& p, BulletMasks& m) {
+    clearMasks(m, firstBlock, lastBlock);
+    std::size_t fullBlocks = std::min(lastBlock, n / 8);
+    for (std::size_t b = firstBlock; b < fullBlocks; ++b) {
+        int e0, x0, h0, a0, e1, x1, h1, a1;
+        sse2Lanes(pool, b * 8, p, e0, x0, h0, a0);
+        sse2Lanes(pool, b * 8 + 4, p, e1, x1, h1, a1);
+        m.exploded[b] = static_cast<std::uint8_t>(e0 | e1 << 4);
+        m.expired[b] = static_cast<std::uint8_t>(x0 | x1 << 4);
+        m.hit[b] = static_cast<std::uint8_t>(h0 | h1 << 4);
+        m.alive[b] = static_cast<std::uint8_t>(a0 | a1 << 4);
+    }
+    std::size_t end = std::min(n, lastBlock * 8);
+    for (std::size_t i = std::max(firstBlock, fullBlocks) * 8; i < end; ++i) step(pool, i, p, m);
+}
+
+__attribute__((target("avx2")))
+inline void runAVX2(BulletPool& pool, std::size_t n, std::size_t firstBlock, std::size_t lastBlock,
+                    const KernelParams& p, BulletMasks& m) {
+    clearMasks(m, firstBlock, lastBlock);
+    const __m256 minX = _mm256_set1_ps(p.minX), maxX = _mm256_set1_ps(p.maxX);
+    const __m256 minY = _mm256_set1_ps(p.minY), maxY = _mm256_set1_ps(p.maxY);
+    const __m256 shedMinX = _mm256_set1_ps(p.shedMinX), shedMaxX = _mm256_set1_ps(p.shedMaxX);
+    const __m256 shedMinY = _mm256_set1_ps(p.shedMinY), shedMaxY = _mm256_set1_ps(p.shedMaxY);
+    const __m256 burst2 = _mm256_set1_ps(p.burstRange2), range2 = _mm256_set1_ps(p.phase3Range2);
+    const __m256 px = _mm256_set1_ps(p.playerX), py = _mm256_set1_ps(p.playerY), pr = _mm256_set1_ps(p.playerRadius);
+    const __m256 pdx = _mm256_set1_ps(p.playerDX), pdy = _mm256_set1_ps(p.playerDY);
+    const __m256 one = _mm256_set1_ps(1.f), four = _mm256_set1_ps(4.f), zero = _mm256_setzero_ps();
+    const __m256i pop = _mm256_set1_epi32(BulletPool::Poprock), p3 = _mm256_set1_epi32(BulletPool::Phase3Shot);
+
+    std::size_t fullBlocks = std::min(lastBlock, n / 8);
+    for (std::size_t b = firstBlock; b < fullBlocks; ++b) {
+        std::size_t i = b * 8;
+        __m256 vx = _mm256_loadu_ps(&pool.vx[i]), vy = _mm256_loadu_ps(&pool.vy[i]);
+        __m256 x = _mm256_add_ps(_mm256_loadu_ps(&pool.x[i]), vx);
+        __m256 y = _mm256_add_ps(_mm256_loadu_ps(&pool.y[i]), vy);
+        __m256 age = _mm256_add_ps(_mm256_loadu_ps(&pool.aliveTime[i]), one);
+        _mm256_storeu_ps(&pool.x[i], x);
+        _mm256_storeu_ps(&pool.y[i], y);
+        _mm256_storeu_ps(&pool.aliveTime[i], age);
+
+        __m256 dx = _mm256_sub_ps(x, _mm256_loadu_ps(&pool.startX[i]));
+        __m256 dy = _mm256_sub_ps(y, _mm256_loadu_ps(&pool.startY[i]));
+        __m256 d2 = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+
+        __m256i f = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(&pool.flags[i])));
+        __m256 isPoprock = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(f, pop), pop));
+        __m256 isPhase3 = _mm256_castsi256_ps(_mm256_cmpeq_epi32(_mm256_and_si256(f, p3), p3));
+
+        __m256 boom = _mm256_and_ps(isPoprock, _mm256_cmp_ps(d2, burst2, _CMP_GT_OQ));
+        __m256 life = _mm256_loadu_ps(&pool.lifeTime[i]);
+        __m256 gone = _mm256_and_ps(_mm256_cmp_ps(life, zero, _CMP_GT_OQ), _mm256_cmp_ps(age, life, _CMP_GE_OQ));
+        gone = _mm256_or_ps(gone, _mm256_and_ps(isPhase3, _mm256_cmp_ps(d2, range2, _CMP_GT_OQ)));
+        gone = _mm256_or_ps(gone, _mm256_or_ps(_mm256_cmp_ps(x, minX, _CMP_LT_OQ), _mm256_cmp_ps(x, maxX, _CMP_GT_OQ)));
+        gone = _mm256_or_ps(gone, _mm256_or_ps(_mm256_cmp_ps(y, minY, _CMP_LT_OQ), _mm256_cmp_ps(y, maxY, _CMP_GT_OQ)));
+
+        __m256 r = _mm256_loadu_ps(&pool.radius[i]);
+        __m256 sx = _mm256_loadu_ps(&pool.scaleX[i]), sy = _mm256_loadu_ps(&pool.scaleY[i]);
+        __m256 extent = _mm256_mul_ps(r, _mm256_max_ps(sx, sy));
+        __m256 shed = _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(x, extent), shedMinX, _CMP_LT_OQ), _mm256_cmp_ps(vx, zero, _CMP_LE_OQ)),
+                                   _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(x, extent), shedMaxX, _CMP_GT_OQ), _mm256_cmp_ps(vx, zero, _CMP_GE_OQ)));
+        shed = _mm256_or_ps(shed, _mm256_or_ps(_mm256_and_ps(_mm256_cmp_ps(_mm256_add_ps(y, extent), shedMinY, _CMP_LT_OQ), _mm256_cmp_ps(vy, zero, _CMP_LE_OQ)),
+                                               _mm256_and_ps(_mm256_cmp_ps(_mm256_sub_ps(y, extent), shedMaxY, _CMP_GT_OQ), _mm256_cmp_ps(vy, zero, _CMP_GE_OQ))));
+        shed = _mm256_andnot_ps(isPoprock, shed);
+        gone = _mm256_andnot_ps(boom, gone);
+
+        __m256 rx = _mm256_div_ps(one, _mm256_add_ps(_mm256_mul_ps(r, sx), pr));
+        __m256 ry = _mm256_div_ps(one, _mm256_add_ps(_mm256_mul_ps(r, sy), pr));
+        __m256 nx = _mm256_mul_ps(_mm256_sub_ps(px, x), rx), ny = _mm256_mul_ps(_mm256_sub_ps(py, y), ry);
+        __m256 wx = _mm256_mul_ps(_mm256_sub_ps(pdx, vx), rx), wy = _mm256_mul_ps(_mm256_sub_ps(pdy, vy), ry);
+        __m256 n2 = _mm256_add_ps(_mm256_mul_ps(nx, nx), _mm256_mul_ps(ny, ny));
+        __m256 w2 = _mm256_add_ps(_mm256_mul_ps(wx, wx), _mm256_mul_ps(wy, wy));
+        __m256 touch = _mm256_cmp_ps(n2, one, _CMP_LT_OQ);
+        if (_mm256_movemask_ps(_mm256_cmp_ps(n2, _mm256_mul_ps(four, _mm256_add_ps(one, w2)), _CMP_LT_OQ))) { // else too far to touch
+            __m256 nw = _mm256_add_ps(_mm256_mul_ps(nx, wx), _mm256_mul_ps(ny, wy));
+            __m256 sx0 = _mm256_sub_ps(nx, wx), sy0 = _mm256_sub_ps(ny, wy);
+            touch = _mm256_or_ps(touch, _mm256_cmp_ps(_mm256_add_ps(_mm256_mul_ps(sx0, sx0), _mm256_mul_ps(sy0, sy0)), one, _CMP_LT_OQ));
+            __m256 between = _mm256_and_ps(_mm256_cmp_ps(nw, zero, _CMP_GT_OQ), _mm256_cmp_ps(nw, w2, _CMP_LT_OQ));
+            touch = _mm256_or_ps(touch, _mm256_and_ps(between, _mm256_cmp_ps(_mm256_mul_ps(_mm256_sub_ps(n2, one), w2), _mm256_mul_ps(nw, nw), _CMP_LT_OQ)));
+        }
+        touch = _mm256_andnot_ps(_mm256_or_ps(boom, gone), touch);
+        gone = _mm256_or_ps(gone, _mm256_andnot_ps(_mm256_or_ps(boom, touch), shed));
+
+        int e = _mm256_movemask_ps(boom), g = _mm256_movemask_ps(gone), h = _mm256_movemask_ps(touch);
+        m.exploded[b] = static_cast<std::uint8_t>(e);
+        m.expired[b] = static_cast<std::uint8_t>(g);
+        m.hit[b] = static_cast<std::uint8_t>(h);
+        m.alive[b] = static_cast<std::uint8_t>(~(e | g | h));
+    }
+    std::size_t end = std::min(n, lastBlock * 8);
+    for (std::size_t i = std::max(firstBlock, fullBlocks) * 8; i < end; ++i) step(pool, i, p, m);
+}
+#endif
+
+} // namespace bullet_kernel
+
+inline bool kernelIsaSupported(KernelIsa isa) {
+#ifdef BULLET_KERNEL_X86
+    if (isa == KernelIsa::AVX2) return __builtin_cpu_supports("avx2");
+    if (isa == KernelIsa::SSE2) return __builtin_cpu_supports("sse2");
+#endif
+    return isa == KernelIsa::Scalar;
+}
+
+// Widest ISA this CPU runs, detected once.
+inline KernelIsa bestKernelIsa() {
+    static const KernelIsa best = kernelIsaSupported(KernelIsa::AVX2) ? KernelIsa::AVX2
+                                : kernelIsaSupported(KernelIsa::SSE2) ? KernelIsa::SSE2 : KernelIsa::Scalar;
+    return best;
+}
+
+// Integrates and classifies blocks [firstBlock, lastBlock) of the pool's live
+// bullets; masks must already be sized for pool.size().
+inline void runBulletKernel(KernelIsa isa, BulletPool& pool, std::size_t firstBlock, std::size_t lastBlock,
+                            const KernelParams& p, BulletMasks& masks) {
+    std::size_t n = pool.size();
+#ifdef BULLET_KERNEL_X86
+    if (isa == KernelIsa::AVX2) return bullet_kernel::runAVX2(pool, n, firstBlock, lastBlock, p, masks);
+    if (isa == KernelIsa::SSE2) return bullet_kernel::runSSE2(pool, n, firstBlock, lastBlock, p, masks);
+#endif
+    (void)isa;
+    bullet_kernel::runScalar(pool, n, firstBlock, lastBlock, p, masks);
+}
+
+inline void runBulletKernel(KernelIsa isa, BulletPool& pool, const KernelParams& p, BulletMasks& masks) {
+    masks.resize(pool.size());
+    runBulletKernel(isa, pool, 0, masks.blocks, p, masks);
+}
@@ -0,0 +1,164 @@
+#pragma once
+#include "GameMath.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <vector>
+
+// --- Bullet Pool ---
+// Enemy projectiles stored as parallel arrays with a fixed capacity.
+// Removal swaps the last live bullet into the freed slot, so order is not
+// preserved and indices are only stable until the next removal.
+struct BulletPool {
+    enum Flags : std::uint8_t {
+        Poprock = 1 << 0,
+        Shard = 1 << 1,
+        Phase3Shot = 1 << 2,
+    };
+
+    static constexpr std::size_t kDefaultCapacity = 4096;
+
+    std::vector<float> x, y;
+    std::vector<float> vx, vy; // pixels per tick
+    std::vector<float> startX, startY;
+    std::vector<float> radius;
+    std::vector<float> scaleX, scaleY;
+    std::vector<float> lifeTime, aliveTime; // ticks; a negative lifeTime never expires
+    std::vector<sf::Color> color;
+    std::vector<std::uint8_t> flags;
+
+    explicit BulletPool(std::size_t capacity = kDefaultCapacity) { reserve(capacity); }
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return x.size(); }
+    bool empty() const { return count == 0; }
+    void clear() { count = 0; }
+
+    // Returns the new bullet's index, or -1 when the pool is full.
+    int spawn(sf::Vector2f position, float angle, float speed, float r, sf::Color c,
+              std::uint8_t kind = 0, float life = -1.0f) {
+        float radians = angle * (PI / 180.0f);
+        return spawnWithVelocity(position, {std::cos(radians) * speed, std::sin(radians) * speed}, r, c, kind, life);
+    }
+
+    int spawnWithVelocity(sf::Vector2f position, sf::Vector2f velocity, float r, sf::Color c,
+                          std::uint8_t kind = 0, float life = -1.0f) {
+        if (count == capacity()) return -1;
+        std::size_t i = count++;
+        x[i] = startX[i] = position.x;
+        y[i] = startY[i] = position.y;
+        vx[i] = velocity.x;
+        vy[i] = velocity.y;
+        radius[i] = r;
+        scaleX[i] = scaleY[i] = 1.f;
+        lifeTime[i] = life;
+        aliveTime[i] = 0.f;
+        color[i] = c;
+        flags[i] = kind;
+        return static_cast<int>(i);
+    }
+
+    // Appends up to n slots whose contents the caller must fill in; returns
+    // how many were added.
+    std::size_t grow(std::size_t n) {
+        n = std::min(n, capacity() - count);
+        count += n;
+        return n;
+    }
+
+    void truncate(std::size_t newSize) { count = std::min(count, newSize); }
+
+    // Sets the fields shared by a whole volley for slots [first, last).
+    void fill(std::size_t first, std::size_t last, float r, sf::Vector2f scale, sf::Color c, std::uint8_t kind, float life) {
+        std::fill(radius.begin() + first, radius.begin() + last, r);
+        std::fill(scaleX.begin() + first, scaleX.begin() + last, scale.x);
+        std::fill(scaleY.begin() + first, scaleY.begin() + last, scale.y);
+        std::fill(color.begin() + first, color.begin() + last, c);
+        std::fill(flags.begin() + first, flags.begin() + last, kind);
+        std::fill(lifeTime.begin() + first, lifeTime.begin() + last, life);
+        std::fill(aliveTime.begin() + first, aliveTime.begin() + last, 0.f);
+    }
+
+    // Raises the capacity, keeping live bullets. Allocates, so only call it
+    // between phases, never from inside a tick.
+    void reserve(std::size_t n) {
+        if (n <= capacity()) return;
+        x.resize(n); y.resize(n);
+        vx.resize(n); vy.resize(n);
+        startX.resize(n); startY.resize(n);
+        radius.resize(n);
+        scaleX.resize(n); scaleY.resize(n);
+        lifeTime.resize(n); aliveTime.resize(n);
+        color.resize(n);
+        flags.resize(n);
+    }
+
+    void removeAt(std::size_t i) {
+        std::size_t last = --count;
+        if (i != last) move(i, last);
+    }
+
+    // Keeps the bullets in [0, n) whose bit is set in keep (bit i % 8 of
+    // byte i / 8): holes are filled from the back, so the cost is one move per
+    // removed bullet rather than per survivor. Bullets past n, spawned after
+    // the mask was built, are then slid down behind the survivors.
+    void compact(const std::uint8_t* keep, std::size_t n) {
+        auto kept = [keep](std::size_t i) { return (keep[i / 8] >> (i % 8)) & 1u; };
+        std::size_t lo = 0, hi = n;
+        for (;;) {
+            while (lo < hi) {
+                if (lo % 8 == 0 && lo + 8 <= hi && keep[lo / 8] == 0xFF) lo += 8; // whole block survives
+                else if (kept(lo)) ++lo;
+                else break;
+            }
+            while (hi > lo && !kept(hi - 1)) --hi;
+            if (lo >= hi) break;
+            move(lo++, --hi);
+        }
+        for (std::size_t i = n; i < count; ++i) move(lo++, i);
+        count = lo;
+    }
+
+    // Removes every index in [first, last); the list is sorted in place.
+    void removeAll(std::uint32_t* first, std::uint32_t* last) {
+        std::sort(first, last, std::greater<std::uint32_t>());
+        last = std::unique(first, last);
+        for (; first != last; ++first) removeAt(*first);
+    }
+
+    sf::Vector2f position(std::size_t i) const { return {x[i], y[i]}; }
+    sf::Vector2f halfSize(std::size_t i) const { return {radius[i] * scaleX[i], radius[i] * scaleY[i]}; }
+
+    // Largest half size of any live bullet, for broadphase padding.
+    float maxExtent() const {
+        float e = 0.f;
+        for (std::size_t i = 0; i < count; ++i) e = std::max(e, radius[i] * std::max(scaleX[i], scaleY[i]));
+        return e;
+    }
+
+    void integrate() {
+        for (std::size_t i = 0; i < count; ++i) {
+            x[i] += vx[i];
+            y[i] += vy[i];
+            aliveTime[i] += 1.f;
+        }
+    }
+
+private:
+    void move(std::size_t to, std::size_t from) {
+        x[to] = x[from]; y[to] = y[from];
+        vx[to] = vx[from]; vy[to] = vy[from];
+        startX[to] = startX[from]; startY[to] = startY[from];
+        radius[to] = radius[from];
+        scaleX[to] = scaleX[from]; scaleY[to] = scaleY[from];
+        lifeTime[to] = lifeTime[from]; aliveTime[to] = aliveTime[from];
+        color[to] = color[from];
+        flags[to] = flags[from];
+    }
+
+    std::size_t count = 0;
+};
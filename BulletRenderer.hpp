@@ -0,0 +1,43 @@
+#pragma once
+#include "BulletBatch.hpp"
+#include <SFML/Graphics/Image.hpp>
+#include <SFML/Graphics/PrimitiveType.hpp>
+#include <SFML/Graphics/RenderStates.hpp>
+#include <SFML/Graphics/RenderTarget.hpp>
+#include <SFML/Graphics/Texture.hpp>
+#include <algorithm>
+#include <cmath>
+
+// --- Bullet Renderer ---
+// Submits a whole BulletBatch with a single draw call. Needs a live GL
+// context, so construct it after the window.
+class BulletRenderer {
+public:
+    BulletRenderer() : circleTexture(makeCircleImage()) {
+        circleTexture.setSmooth(true);
+    }
+
+    void draw(sf::RenderTarget& target, const BulletBatch& batch) const {
+        if (batch.vertices.empty()) return;
+        sf::RenderStates states;
+        states.texture = &circleTexture;
+        target.draw(batch.vertices.data(), batch.vertices.size(), sf::PrimitiveType::Triangles, states);
+    }
+
+private:
+    static sf::Image makeCircleImage() {
+        unsigned size = static_cast<unsigned>(BulletBatch::kTextureSize);
+        float r = BulletBatch::kTextureSize / 2.f;
+        sf::Image image({size, size}, sf::Color::Transparent);
+        for (unsigned py = 0; py < size; ++py) {
+            for (unsigned px = 0; px < size; ++px) {
+                float dx = px + 0.5f - r, dy = py + 0.5f - r;
+                float coverage = std::clamp(r - std::sqrt(dx * dx + dy * dy), 0.f, 1.f);
+                image.setPixel({px, py}, sf::Color(255, 255, 255, static_cast<std::uint8_t>(coverage * 255.f)));
+            }
+        }
+        return image;
+    }
+
+    sf::Texture circleTexture;
+};
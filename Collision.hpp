@@ -0,0 +1,94 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+// --- Narrowphase Tests ---
+// Touching shapes do not count as a hit, matching FloatRect::findIntersection.
+
+inline bool circleCircle(sf::Vector2f a, float ra, sf::Vector2f b, float rb) {
+    sf::Vector2f d = a - b;
+    float r = ra + rb;
+    return d.x * d.x + d.y * d.y < r * r;
+}
+
+// Axis-aligned rectangle given by its centre and half extents.
+inline bool circleRect(sf::Vector2f c, float r, sf::Vector2f rectCenter, sf::Vector2f halfSize) {
+    sf::Vector2f d = c - rectCenter;
+    sf::Vector2f closest{std::clamp(d.x, -halfSize.x, halfSize.x), std::clamp(d.y, -halfSize.y, halfSize.y)};
+    sf::Vector2f e = d - closest;
+    return e.x * e.x + e.y * e.y < r * r;
+}
+
+// Axis-aligned ellipse (a circle with non-uniform scale) against a circle.
+// Exact along both axes and slightly generous on the diagonals.
+inline bool ellipseCircle(sf::Vector2f c, sf::Vector2f semiAxes, sf::Vector2f b, float rb) {
+    sf::Vector2f d = b - c;
+    float nx = d.x / (semiAxes.x + rb), ny = d.y / (semiAxes.y + rb);
+    return nx * nx + ny * ny < 1.f;
+}
+
+// Capsule (segment a-b swept by radius ra) against a circle: exact.
+inline bool capsuleCircle(sf::Vector2f a, sf::Vector2f b, float ra, sf::Vector2f c, float rc) {
+    sf::Vector2f ab = b - a, ac = c - a;
+    float len2 = ab.x * ab.x + ab.y * ab.y;
+    float t = len2 > 0.f ? std::clamp((ac.x * ab.x + ac.y * ab.y) / len2, 0.f, 1.f) : 0.f;
+    return circleCircle(a + ab * t, ra, c, rc);
+}
+
+// --- Swept Tests ---
+// Each shape moves in a straight line over one tick: a by da, b by db. The
+// tests return the earliest fraction of the tick, in [0, 1), at which the two
+// overlap (0 if they already do as it starts), or -1 if they never do, so a
+// fast mover cannot step over a target between ticks.
+
+// Point p moving by v against the circle of radius r about the origin.
+inline float sweptPointCircle(sf::Vector2f p, sf::Vector2f v, float r) {
+    float c = p.x * p.x + p.y * p.y - r * r;
+    if (c < 0.f) return 0.f;
+    float a = v.x * v.x + v.y * v.y, b = p.x * v.x + p.y * v.y;
+    float disc = b * b - a * c;
+    if (a == 0.f || b >= 0.f || disc <= 0.f) return -1.f;
+    float t = (-b - std::sqrt(disc)) / a;
+    return t < 1.f ? t : -1.f;
+}
+
+inline float sweptCircleCircle(sf::Vector2f a, sf::Vector2f da, float ra, sf::Vector2f b, sf::Vector2f db, float rb) {
+    return sweptPointCircle(b - a, db - da, ra + rb);
+}
+
+// Same shapes and the same generosity as ellipseCircle(): scaled by the
+// summed axes, the test is a point against the unit circle.
+inline float sweptEllipseCircle(sf::Vector2f c, sf::Vector2f dc, sf::Vector2f semiAxes, sf::Vector2f b, sf::Vector2f db, float rb) {
+    sf::Vector2f s{semiAxes.x + rb, semiAxes.y + rb};
+    sf::Vector2f p = b - c, v = db - dc;
+    return sweptPointCircle({p.x / s.x, p.y / s.y}, {v.x / s.x, v.y / s.y}, 1.f);
+}
+
+// The circle's centre against the rectangle grown by r, whose corners are
+// quarter circles: the slabs give the entry time, and an entry across a
+// corner is settled by that corner's circle.
+inline float sweptCircleRect(sf::Vector2f c, sf::Vector2f dc, float r, sf::Vector2f rectCenter, sf::Vector2f dRect, sf::Vector2f halfSize) {
+    if (circleRect(c, r, rectCenter, halfSize)) return 0.f;
+    sf::Vector2f p = c - rectCenter, v = dc - dRect;
+    float enter = 0.f, exit = 1.f;
+    for (int axis = 0; axis < 2; ++axis) {
+        float pa = axis ? p.y : p.x, va = axis ? v.y : v.x, h = (axis ? halfSize.y : halfSize.x) + r;
+        if (va == 0.f) {
+            if (pa <= -h || pa >= h) return -1.f;
+            continue;
+        }
+        float t0 = (-h - pa) / va, t1 = (h - pa) / va;
+        if (t0 > t1) std::swap(t0, t1);
+        enter = std::max(enter, t0);
+        exit = std::min(exit, t1);
+    }
+    if (enter >= exit) return -1.f;
+    sf::Vector2f q = p + v * enter;
+    if (std::abs(q.x) > halfSize.x && std::abs(q.y) > halfSize.y) {
+        sf::Vector2f corner{std::copysign(halfSize.x, q.x), std::copysign(halfSize.y, q.y)};
+        return sweptPointCircle(p - corner, v, r);
+    }
+    return enter;
+}
@@ -0,0 +1,104 @@
+#pragma once
+#include "GameMath.hpp"
+#include <array>
+#include <cmath>
+#include <cstddef>
+
+// --- Direction Tables ---
+// Unit directions for whole-degree angles, built at compile time, so ring
+// emitters and poprock shards get their velocities without trig calls. A
+// volley's rotation offset is applied to the whole table as one Rotation
+// (a single sin/cos per volley instead of one per bullet).
+//
+// Table entries agree with std::cos/std::sin of the same angle to within
+// kDirectionTolerance; headless --check verifies it.
+
+inline constexpr float kDirectionTolerance = 1e-5f;
+
+struct Direction {
+    float x = 1.f, y = 0.f;
+};
+
+namespace direction_detail {
+
+// Taylor series in double around 0 after reducing to [-180, 180) degrees;
+// 30 terms is far past float precision over that range.
+constexpr double sinDegrees(double degrees) {
+    double d = degrees - 360.0 * static_cast<long long>(degrees / 360.0);
+    if (d >= 180.0) d -= 360.0;
+    if (d < -180.0) d += 360.0;
+    double x = d * (3.14159265358979323846 / 180.0);
+    double term = x, sum = x;
+    for (int n = 1; n < 30; ++n) {
+        term *= -x * x / ((2.0 * n) * (2.0 * n + 1.0));
+        sum += term;
+    }
+    return sum;
+}
+
+constexpr double cosDegrees(double degrees) { return sinDegrees(degrees + 90.0); }
+
+constexpr std::array<Direction, 360> makeUnitTable() {
+    std::array<Direction, 360> table{};
+    for (int deg = 0; deg < 360; ++deg) {
+        table[deg] = {static_cast<float>(cosDegrees(deg)), static_cast<float>(sinDegrees(deg))};
+    }
+    return table;
+}
+
+template <int Count, int Step>
+constexpr std::array<Direction, Count> makeRing() {
+    std::array<Direction, Count> ring{};
+    for (int i = 0; i < Count; ++i) {
+        ring[i] = {static_cast<float>(cosDegrees(i * Step)), static_cast<float>(sinDegrees(i * Step))};
+    }
+    return ring;
+}
+
+} // namespace direction_detail
+
+inline constexpr std::array<Direction, 360> kUnitDirections = direction_detail::makeUnitTable();
+
+// The ring shapes the built-in patterns fire, as their own tables.
+template <int Count, int Step>
+struct RingTable {
+    static constexpr std::array<Direction, Count> directions = direction_detail::makeRing<Count, Step>();
+};
+
+// Directions i * step for i in [0, count), or nullptr if (count, step) is
+// not one of the specialised rings.
+inline const Direction* ringDirections(int count, float step) {
+    static const struct { int count; float step; const Direction* directions; } rings[] = {
+        {12, 30.f, RingTable<12, 30>::directions.data()},
+        {36, 10.f, RingTable<36, 10>::directions.data()},
+        {6, 60.f, RingTable<6, 60>::directions.data()},
+        {4, 90.f, RingTable<4, 90>::directions.data()},
+    };
+    for (const auto& r : rings) {
+        if (r.count == count && r.step == step) return r.directions;
+    }
+    return nullptr;
+}
+
+// Table lookup for whole-degree angles, trig otherwise.
+inline Direction unitDirection(float degrees) {
+    float whole = std::floor(degrees);
+    if (whole == degrees && std::abs(degrees) < 1e6f) {
+        int d = static_cast<int>(whole) % 360;
+        return kUnitDirections[d < 0 ? d + 360 : d];
+    }
+    float rad = degrees * (PI / 180.f);
+    return {std::cos(rad), std::sin(rad)};
+}
+
+// A rotation by a fixed angle, applied to table directions.
+struct Rotation {
+    float c = 1.f, s = 0.f;
+
+    Rotation() = default;
+    explicit Rotation(float degrees) : Rotation(unitDirection(degrees)) {}
+    explicit Rotation(Direction d) : c(d.x), s(d.y) {}
+
+    Direction apply(Direction d) const { return {c * d.x - s * d.y, s * d.x + c * d.y}; }
+    Rotation then(const Rotation& r) const { return Rotation(r.apply({c, s})); }
+};
@@ -0,0 +1,98 @@
+#pragma once
+#include <algorithm>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <type_traits>
+#include <vector>
+
+// --- Frame Arena ---
+// Bump allocator for buffers that live for a single tick. reset() at the
+// start of each tick frees everything at once. A tick that asks for more
+// than the arena holds gets its overflow from the heap; the next reset()
+// regrows the arena to that high-water mark, so after the first few ticks
+// of a new load nothing here touches the heap again.
+//
+// Only for trivially destructible types; nothing is ever destroyed.
+class FrameArena {
+public:
+    explicit FrameArena(std::size_t bytes = 0) { grow(bytes); }
+
+    // Copies start empty with the same capacity: arena contents never
+    // outlive a tick, so there is nothing worth copying.
+    FrameArena(const FrameArena& other) : FrameArena(other.capacity()) {}
+    FrameArena& operator=(const FrameArena& other) {
+        if (this != &other && capacity() < other.capacity()) grow(other.capacity());
+        reset();
+        return *this;
+    }
+
+    template <typename T>
+    T* allocate(std::size_t n) {
+        static_assert(std::is_trivially_destructible<T>::value, "arena memory is never destroyed");
+        std::size_t bytes = n * sizeof(T);
+        std::size_t offset = (used + alignof(T) - 1) & ~(alignof(T) - 1);
+        if (offset + bytes <= blockBytes) {
+            used = offset + bytes;
+            peak = std::max(peak, used);
+            return reinterpret_cast<T*>(reinterpret_cast<unsigned char*>(block.get()) + offset);
+        }
+        overflow.emplace_back(new std::max_align_t[bytes / sizeof(std::max_align_t) + 1]);
+        overflowBytes += bytes + alignof(std::max_align_t);
+        peak = std::max(peak, used + overflowBytes);
+        return reinterpret_cast<T*>(overflow.back().get());
+    }
+
+    // Grows the arena ahead of time; only call it between ticks.
+    void reserve(std::size_t bytes) { grow(bytes); }
+
+    void reset() {
+        used = 0;
+        if (!overflow.empty()) {
+            overflow.clear();
+            overflowBytes = 0;
+            grow(peak);
+        }
+    }
+
+    std::size_t capacity() const { return blockBytes; }
+    std::size_t bytesUsed() const { return used + overflowBytes; }
+
+private:
+    void grow(std::size_t bytes) {
+        if (bytes <= blockBytes || used != 0) return;
+        // The block only ever holds scratch data, so nothing is carried over.
+        std::size_t units = (bytes + bytes / 2) / sizeof(std::max_align_t) + 1;
+        block.reset(new std::max_align_t[units]);
+        blockBytes = units * sizeof(std::max_align_t);
+    }
+
+    std::unique_ptr<std::max_align_t[]> block;
+    std::vector<std::unique_ptr<std::max_align_t[]>> overflow;
+    std::size_t blockBytes = 0, used = 0, overflowBytes = 0, peak = 0;
+};
+
+// Fixed-capacity list carved from a FrameArena; the caller sizes it for the
+// worst case up front, so push_back never reallocates.
+template <typename T>
+struct FrameVector {
+    T* items = nullptr;
+    std::size_t count = 0, limit = 0;
+
+    FrameVector() = default;
+    FrameVector(FrameArena& arena, std::size_t capacity) : items(arena.allocate<T>(capacity)), limit(capacity) {}
+
+    void push_back(const T& v) {
+        assert(count < limit);
+        items[count++] = v;
+    }
+    void clear() { count = 0; }
+    std::size_t size() const { return count; }
+    bool empty() const { return count == 0; }
+    T* begin() { return items; }
+    T* end() { return items + count; }
+    const T* begin() const { return items; }
+    const T* end() const { return items + count; }
+    T& operator[](std::size_t i) { return items[i]; }
+};
@@ -0,0 +1,113 @@
+#pragma once
+#include "Profiler.hpp"
+#include <array>
+#include <cstdio>
+
+// --- Frame Governor ---
+// Keeps a frame's simulation and drawing inside a time budget by shedding
+// load one level at a time, cheapest to notice first:
+//   cull offscreen - drop bullets as soon as they leave the arena for good
+//                    instead of at the 150 px margin
+//   cap shards     - skip poprock shards that could never enter the arena.
+//                    Shards are live bullets and the player outpaces them,
+//                    so no others are safe to drop. The shipped patterns
+//                    burst poprocks within 400 px of the boss, which leaves
+//                    none: the level is a no-op for them and only sheds for
+//                    pattern files whose poprocks burst near or past an edge
+//   lite render    - draw bullets at their tick positions, without
+//                    interpolation, and only those inside the view
+//   fewer substeps - catch up at most two ticks per frame, so a slow patch
+//                    slows the game down instead of dropping frames
+// Every level is cumulative. None of them changes anything within reach of
+// the player: the first two only touch bullets that fly in a straight line
+// away from the arena, and the last two only change how often ticks run and
+// how they are drawn, never what they do.
+//
+// The cost is smoothed over frames. It escalates after escalateFrames frames
+// over budget and relaxes after relaxFrames frames under relaxFraction of
+// it, so a single spike or a quiet moment does not make it flap. Each change
+// is logged to stderr with the cost that caused it, the current level is a
+// profiler counter, and report() prints how many frames ran at each level.
+enum class ShedLevel { Normal, CullOffscreen, CapShards, LiteRender, FewerSubsteps };
+
+class FrameGovernor {
+public:
+    static constexpr int kLevelCount = 5;
+    static constexpr unsigned kAllLevels = (1u << kLevelCount) - 1;
+
+    struct Params {
+        float budget = 0.012f;      // seconds of sim + draw per frame
+        float smoothing = 0.1f;     // weight of the newest frame in the average
+        int escalateFrames = 15;
+        int relaxFrames = 180;
+        float relaxFraction = 0.6f;
+    };
+
+    // allowed is a mask of 1 << ShedLevel; levels not in it are skipped.
+    // Normal is always allowed.
+    explicit FrameGovernor(const Params& params, unsigned allowed = kAllLevels)
+        : params(params), allowed(allowed | 1u) {}
+
+    static const char* levelName(ShedLevel level) {
+        static const char* const names[kLevelCount] = {"normal", "cull offscreen", "cap shards", "lite render", "fewer substeps"};
+        return names[static_cast<int>(level)];
+    }
+
+    ShedLevel level() const { return current; }
+
+    // True when the current level includes shedding at the given level.
+    bool sheds(ShedLevel l) const { return current >= l && (allowed >> static_cast<int>(l) & 1u); }
+
+    // Feeds one frame's measured costs, in seconds.
+    void update(float simSeconds, float drawSeconds) {
+        float cost = simSeconds + drawSeconds;
+        float weight = frames == 0 ? 1.f : params.smoothing;
+        average += (cost - average) * weight;
+        avgSim += (simSeconds - avgSim) * weight;
+        avgDraw += (drawSeconds - avgDraw) * weight;
+        ++frames;
+        ++framesAt[static_cast<int>(current)];
+
+        overFrames = average > params.budget ? overFrames + 1 : 0;
+        underFrames = average < params.budget * params.relaxFraction ? underFrames + 1 : 0;
+        if (overFrames >= params.escalateFrames) {
+            int next = static_cast<int>(current) + 1;
+            while (next < kLevelCount && !(allowed >> next & 1u)) ++next;
+            if (next < kLevelCount) change(static_cast<ShedLevel>(next), "over budget");
+            overFrames = 0;
+        } else if (underFrames >= params.relaxFrames && current != ShedLevel::Normal) {
+            int prev = static_cast<int>(current) - 1;
+            while (prev > 0 && !(allowed >> prev & 1u)) --prev;
+            change(static_cast<ShedLevel>(prev), "under budget");
+            underFrames = 0;
+        }
+        PROFILE_COUNT("governor level", static_cast<int>(current));
+    }
+
+    void report(std::FILE* out) const {
+        std::fprintf(out, "governor: %ld frames, %d level changes; frames at", frames, changes);
+        const char* sep = " ";
+        for (int l = 0; l < kLevelCount; ++l) {
+            if (!framesAt[l]) continue;
+            std::fprintf(out, "%s%s %ld", sep, levelName(static_cast<ShedLevel>(l)), framesAt[l]);
+            sep = ", ";
+        }
+        std::fprintf(out, "\n");
+    }
+
+private:
+    void change(ShedLevel to, const char* why) {
+        std::fprintf(stderr, "governor: %s -> %s, %s (%.2f ms of %.2f ms: sim %.2f, draw %.2f) at frame %ld\n",
+                     levelName(current), levelName(to), why, average * 1e3f, params.budget * 1e3f, avgSim * 1e3f, avgDraw * 1e3f, frames);
+        current = to;
+        ++changes;
+    }
+
+    Params params;
+    unsigned allowed;
+    ShedLevel current = ShedLevel::Normal;
+    float average = 0.f, avgSim = 0.f, avgDraw = 0.f;
+    int overFrames = 0, underFrames = 0, changes = 0;
+    long frames = 0;
+    std::array<long, kLevelCount> framesAt{};
+};
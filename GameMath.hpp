@@ -0,0 +1,3 @@
+#pragma once
+
+constexpr float PI = 3.14159265f;
@@ -0,0 +1,148 @@
+#pragma once
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// --- Job System ---
+// A fixed set of worker threads running one parallel-for at a time. The
+// range is cut into chunks that are dealt out in contiguous runs, one run
+// per worker queue; a worker drains its own queue front to back and, once
+// empty, steals from the back of the others. The calling thread joins in as
+// worker 0 and parallelFor() returns when every chunk is done.
+//
+// Which worker runs which chunk depends on timing, so callers that need
+// reproducible results key their output by chunk or item, never by worker.
+class JobSystem {
+public:
+    // threads counts the calling thread; 0 means one per hardware thread.
+    explicit JobSystem(unsigned threads = 0)
+        : queues(threads ? threads : std::max(1u, std::thread::hardware_concurrency())) {
+        for (unsigned w = 1; w < queues.size(); ++w) workers.emplace_back([this, w] { workerLoop(w); });
+    }
+
+    ~JobSystem() {
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_all();
+        for (std::thread& t : workers) t.join();
+    }
+
+    JobSystem(const JobSystem&) = delete;
+    JobSystem& operator=(const JobSystem&) = delete;
+
+    unsigned workerCount() const { return static_cast<unsigned>(queues.size()); }
+
+    // Calls fn(begin, end, worker) over [0, count) in chunks of at most grain
+    // items. worker is in [0, workerCount()).
+    template <typename Fn>
+    void parallelFor(std::size_t count, std::size_t grain, const Fn& fn) {
+        if (count == 0) return;
+        grain = std::max<std::size_t>(grain, 1);
+        std::size_t chunks = (count + grain - 1) / grain;
+        if (chunks == 1 || queues.size() == 1) {
+            for (std::size_t c = 0; c < chunks; ++c) fn(c * grain, std::min(count, (c + 1) * grain), 0u);
+            return;
+        }
+
+        job.context = &fn;
+        job.invoke = [](const void* ctx, std::size_t b, std::size_t e, unsigned w) { (*static_cast<const Fn*>(ctx))(b, e, w); };
+        job.count = count;
+        job.grain = grain;
+        std::size_t perQueue = (chunks + queues.size() - 1) / queues.size();
+        for (std::size_t w = 0; w < queues.size(); ++w) {
+            std::lock_guard<std::mutex> lock(queues[w].mutex);
+            queues[w].front = std::min(chunks, w * perQueue);
+            queues[w].back = std::min(chunks, (w + 1) * perQueue);
+        }
+        remaining.store(chunks, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            busy = static_cast<unsigned>(workers.size());
+            ++generation;
+        }
+        wake.notify_all();
+
+        drain(0);
+        while (remaining.load(std::memory_order_acquire) != 0 || busyWorkers() != 0) std::this_thread::yield();
+    }
+
+private:
+    struct Queue {
+        std::mutex mutex;
+        std::size_t front = 0, back = 0; // chunk indices still to run
+    };
+
+    struct Job {
+        const void* context = nullptr;
+        void (*invoke)(const void*, std::size_t, std::size_t, unsigned) = nullptr;
+        std::size_t count = 0, grain = 1;
+    };
+
+    bool popOwn(unsigned w, std::size_t& chunk) {
+        std::lock_guard<std::mutex> lock(queues[w].mutex);
+        if (queues[w].front == queues[w].back) return false;
+        chunk = queues[w].front++;
+        return true;
+    }
+
+    bool steal(unsigned thief, std::size_t& chunk) {
+        for (std::size_t k = 1; k < queues.size(); ++k) {
+            Queue& q = queues[(thief + k) % queues.size()];
+            std::lock_guard<std::mutex> lock(q.mutex);
+            if (q.front == q.back) continue;
+            chunk = --q.back;
+            return true;
+        }
+        return false;
+    }
+
+    void drain(unsigned w) {
+        std::size_t chunk;
+        while (remaining.load(std::memory_order_acquire) != 0) {
+            if (!popOwn(w, chunk) && !steal(w, chunk)) {
+                std::this_thread::yield();
+                continue;
+            }
+            std::size_t begin = chunk * job.grain;
+            job.invoke(job.context, begin, std::min(job.count, begin + job.grain), w);
+            remaining.fetch_sub(1, std::memory_order_acq_rel);
+        }
+    }
+
+    unsigned busyWorkers() {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        return busy;
+    }
+
+    void workerLoop(unsigned w) {
+        unsigned long seen = 0;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait(lock, [&] { return stopping || generation != seen; });
+                if (stopping) return;
+                seen = generation;
+            }
+            drain(w);
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            --busy;
+        }
+    }
+
+    std::vector<Queue> queues;
+    std::vector<std::thread> workers;
+    Job job;
+    std::atomic<std::size_t> remaining{0};
+
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    unsigned long generation = 0;
+    unsigned busy = 0;
+    bool stopping = false;
+};
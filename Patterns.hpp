@@ -0,0 +1,515 @@
+#pragma once
+#include "Beam.hpp"
+#include "BulletPool.hpp"
+#include "DirectionTable.hpp"
+#include "GameMath.hpp"
+#include "Rng.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+
+// --- Bullet Patterns ---
+// Attacks are data: a pattern is a list of emitters, each with its own
+// cadence and rotation accumulator. Patterns are parsed from a compact text
+// format, one emitter per line under a "pattern NAME" header:
+//
+//   pattern spiral
+//   ring delay=0.12 period=0.4 count=12 step=30 spin=20 speed=5 radius=7 color=255,0,0
+//
+// Kinds: ring (count bullets step degrees apart), fan (ring centred on the
+// player), gapring (ring minus a gap degrees hole towards the player), rain
+// (count bullets from random x along the top edge), wall (count columns step
+// px apart with a run of gap missing columns), spokes (count stationary lines
+// of bullets from..to px out, spacing px apart), edges (one bullet inward from
+// each screen edge), beams (count beams step degrees apart reaching from..to
+// px out; each volley replaces the emitter's previous beams).
+//
+// Keys: delay/period/life in seconds, speed in px per 60 Hz frame, spin in
+// degrees per volley, jitter adds 0..jitter-1 to speed, wobble=AMP,FREQ sways
+// bullet i by AMP*sin(t*FREQ + i) degrees, random=1 fires at a random angle,
+// origin=towers fires from each tower, flags=poprock|phase3|shard, scale=X,Y,
+// burst=RANGE,COUNT,STEP,SPEED,RADIUS sets how poprocks detonate. Beams take
+// radius as half their thickness, sweep in degrees per second, warn as the
+// harmless lead-in in seconds and life (omitted: until the pattern stops).
+// Density does not multiply beams. Counts and jitter must lie in 0..4096,
+// as must a spokes volley and gap, colour channels in 0..255, times at most an
+// hour, period and burst speed above zero.
+
+enum class EmitterKind : std::uint8_t { Ring, Fan, GapRing, Rain, Wall, Spokes, Edges, Beams };
+enum class EmitterOrigin : std::uint8_t { Boss, Towers };
+
+struct BurstDef {
+    float range = 400.f;
+    int count = 12;
+    float step = 30.f, speed = 5.f, radius = 6.f;
+};
+
+struct EmitterDef {
+    EmitterKind kind = EmitterKind::Ring;
+    EmitterOrigin origin = EmitterOrigin::Boss;
+    float delay = 0.f, period = 1.f;
+    int count = 1;
+    float step = 0.f, spin = 0.f;
+    float speed = 0.f;
+    int jitter = 0;
+    float radius = 7.f;
+    sf::Color color = sf::Color::Red;
+    std::uint8_t flags = 0;
+    float life = -1.f;
+    sf::Vector2f scale{1.f, 1.f};
+    float gap = 0.f;
+    float wobble = 0.f, wobbleFreq = 0.f;
+    bool randomAngle = false;
+    float from = 0.f, to = 0.f, spacing = 1.f;
+    float sweep = 0.f, warn = 0.f;
+
+    // Bullets along each spoke, from `from` up to but not including `to`.
+    // The loader keeps this and count * this within its count limit.
+    double spokeLength() const { return std::max(0.0, std::ceil((double(to) - from) / spacing)); }
+    int spokeSteps() const { return static_cast<int>(spokeLength()); }
+
+    // Upper bound on bullets in one volley, before density scaling.
+    int volleySize(int towerCount) const {
+        switch (kind) {
+            case EmitterKind::Beams: return 0;
+            case EmitterKind::Spokes: return count * spokeSteps();
+            case EmitterKind::Edges: return 4;
+            default: return count * (origin == EmitterOrigin::Towers ? towerCount : 1);
+        }
+    }
+};
+
+struct PatternDef {
+    static constexpr int kMaxEmitters = 8;
+
+    std::string name;
+    std::vector<EmitterDef> emitters;
+    BurstDef burst;
+
+    // Rough peak of live bullets: emission rate times how long each bullet
+    // lives (its lifetime, or the time to cross the arena).
+    std::size_t estimatePeak(int towerCount) const {
+        float total = 0.f;
+        for (const EmitterDef& e : emitters) {
+            float perSecond = e.volleySize(towerCount) / std::max(e.period, 0.001f);
+            float lifetime = e.life > 0.f ? e.life : e.speed > 0.f ? 2500.f / (e.speed * 60.f) : 1.f;
+            if (e.flags & BulletPool::Poprock) total += perSecond * burst.count * (2500.f / (burst.speed * 60.f));
+            total += perSecond * lifetime;
+        }
+        return static_cast<std::size_t>(total * 1.25f) + 64;
+    }
+
+    // Width of the first wall emitter's row of bullets, or 0 without one.
+    float wallWidth() const {
+        for (const EmitterDef& e : emitters) {
+            if (e.kind == EmitterKind::Wall) return e.count * e.step;
+        }
+        return 0.f;
+    }
+};
+
+inline const char* const kDefaultPatterns = R"(
+pattern spiral
+ring delay=0.12 period=0.4 count=12 step=30 spin=20 speed=5 radius=7 color=255,0,0
+pattern rain
+rain delay=0.12 period=0.15 count=12 speed=7 jitter=4 radius=7 color=255,0,0
+pattern gaps
+gapring delay=0.12 period=0.17 count=36 step=10 gap=15 speed=16 radius=7 color=0,255,0 flags=phase3
+pattern cross
+ring delay=0.12 period=0.3 count=6 step=60 spin=15 speed=13 radius=7 color=255,0,0
+ring delay=0.12 period=0.3 count=6 step=60 spin=15 speed=8 radius=7 color=255,0,0
+pattern shotgun
+fan delay=0.12 period=0.5 count=7 step=15 speed=14 radius=25 color=255,165,0
+pattern stream
+fan delay=0.12 period=0.12 count=3 step=10 speed=14 radius=9 color=255,0,0
+pattern knife_wall
+wall delay=1.1 period=1.1 count=12 step=55 gap=2 speed=8 radius=15 color=220,220,220 scale=0.6,1.8
+pattern dense_cross
+beams delay=0.08 period=15 count=4 step=90 sweep=25 from=60 to=1200 radius=11 color=0,255,100
+edges delay=0.08 period=0.08 speed=7 radius=7 color=150,255,150
+pattern miasma_towers
+ring delay=0.05 period=0.05 count=4 step=90 spin=2 wobble=15,5 speed=7 radius=7 color=255,150,0
+ring delay=0.75 period=0.75 random=1 speed=4 radius=15 color=255,255,0 flags=poprock burst=400,12,30,5,6
+ring origin=towers delay=0.7 period=0.7 count=6 step=60 spin=35 speed=4.5 radius=9 color=255,100,255
+)";
+
+// --- Pattern Library ---
+class PatternLibrary {
+public:
+    PatternLibrary() { parse(kDefaultPatterns, nullptr); }
+
+    // Adds the patterns in `text`, replacing any with the same name. On a
+    // malformed line nothing is changed and `error` says where.
+    bool parse(const std::string& text, std::string* error) {
+        std::vector<PatternDef> parsed;
+        std::istringstream lines(text);
+        std::string line;
+        for (int lineNo = 1; std::getline(lines, line); ++lineNo) {
+            line = line.substr(0, line.find('#'));
+            std::istringstream words(line);
+            std::string head;
+            if (!(words >> head)) continue;
+            if (head == "pattern") {
+                parsed.emplace_back();
+                if (!(words >> parsed.back().name)) return fail(error, lineNo, "pattern needs a name");
+                continue;
+            }
+            if (parsed.empty()) return fail(error, lineNo, "emitter before any pattern line");
+            if (parsed.back().emitters.size() == PatternDef::kMaxEmitters) return fail(error, lineNo, "too many emitters");
+            EmitterDef e;
+            if (!parseKind(head, e.kind)) return fail(error, lineNo, "unknown emitter kind '" + head + "'");
+            std::string kv;
+            while (words >> kv) {
+                std::size_t eq = kv.find('=');
+                if (eq == std::string::npos || !parseKey(kv.substr(0, eq), kv.substr(eq + 1), e, parsed.back().burst)) {
+                    return fail(error, lineNo, "bad setting '" + kv + "'");
+                }
+            }
+            if (e.period <= 0.f) return fail(error, lineNo, "period must be positive");
+            if (e.kind == EmitterKind::Spokes && e.spokeLength() * std::max(e.count, 1) > kMaxCount) {
+                return fail(error, lineNo, "spokes hold more than " + std::to_string(static_cast<int>(kMaxCount)) + " bullets");
+            }
+            parsed.back().emitters.push_back(e);
+        }
+        for (PatternDef& p : parsed) {
+            int i = find(p.name);
+            if (i >= 0) patterns[i] = std::move(p);
+            else patterns.push_back(std::move(p));
+        }
+        for (unsigned char c : text) { textHash ^= c; textHash *= 0x100000001b3ull; }
+        textHash ^= 0xff; // ends this text, so a split differs from the whole
+        textHash *= 0x100000001b3ull;
+        return true;
+    }
+
+    // FNV-1a over the text of every successful parse() in order, defaults
+    // first. Replays store it to tell which library they were recorded with.
+    std::uint64_t fingerprint() const { return textHash; }
+
+    bool loadFile(const std::string& path, std::string* error) {
+        std::ifstream in(path);
+        if (!in) {
+            if (error) *error = "cannot open " + path;
+            return false;
+        }
+        std::stringstream text;
+        text << in.rdbuf();
+        return parse(text.str(), error);
+    }
+
+    int find(const std::string& name) const {
+        for (std::size_t i = 0; i < patterns.size(); ++i) {
+            if (patterns[i].name == name) return static_cast<int>(i);
+        }
+        return -1;
+    }
+
+    const PatternDef& operator[](int i) const { return patterns[i]; }
+    int size() const { return static_cast<int>(patterns.size()); }
+
+private:
+    static bool fail(std::string* error, int lineNo, const std::string& what) {
+        if (error) *error = "line " + std::to_string(lineNo) + ": " + what;
+        return false;
+    }
+
+    static bool parseKind(const std::string& s, EmitterKind& kind) {
+        static const std::pair<const char*, EmitterKind> kinds[] = {
+            {"ring", EmitterKind::Ring}, {"fan", EmitterKind::Fan}, {"gapring", EmitterKind::GapRing},
+            {"rain", EmitterKind::Rain}, {"wall", EmitterKind::Wall}, {"spokes", EmitterKind::Spokes},
+            {"edges", EmitterKind::Edges}, {"beams", EmitterKind::Beams},
+        };
+        for (auto& k : kinds) {
+            if (s == k.first) { kind = k.second; return true; }
+        }
+        return false;
+    }
+
+    // Reads up to n comma-separated floats; returns how many were read, or
+    // -1 if anything else is left over.
+    static int parseFloats(std::string s, float* out, int n) {
+        std::replace(s.begin(), s.end(), ',', ' ');
+        std::istringstream in(s);
+        int read = 0;
+        while (read < n && in >> out[read]) ++read;
+        in >> std::ws;
+        return in.eof() ? read : -1;
+    }
+
+    // Counts, channels and durations (as ticks) are cast to integers, so
+    // anything outside the target range is refused up front.
+    static constexpr float kMaxCount = 4096.f;
+    static constexpr float kMaxSeconds = 3600.f;
+    static bool isCount(float v) { return v >= 0.f && v <= kMaxCount; }
+    static bool isChannel(float v) { return v >= 0.f && v <= 255.f; }
+    static bool isDuration(float v) { return v >= 0.f && v <= kMaxSeconds; }
+
+    static bool parseKey(const std::string& key, const std::string& value, EmitterDef& e, BurstDef& burst) {
+        float v[5];
+        int n = parseFloats(value, v, 5);
+        if (key == "origin") {
+            if (value == "boss") e.origin = EmitterOrigin::Boss;
+            else if (value == "towers") e.origin = EmitterOrigin::Towers;
+            else return false;
+            return true;
+        }
+        if (key == "flags") {
+            std::istringstream names(value);
+            std::string flag;
+            e.flags = 0;
+            while (std::getline(names, flag, '|')) {
+                if (flag == "poprock") e.flags |= BulletPool::Poprock;
+                else if (flag == "shard") e.flags |= BulletPool::Shard;
+                else if (flag == "phase3") e.flags |= BulletPool::Phase3Shot;
+                else return false;
+            }
+            return true;
+        }
+        if (key == "color") {
+            if (n != 3 && n != 4) return false;
+            if (!std::all_of(v, v + n, isChannel)) return false;
+            e.color = sf::Color(static_cast<std::uint8_t>(v[0]), static_cast<std::uint8_t>(v[1]), static_cast<std::uint8_t>(v[2]),
+                                n == 4 ? static_cast<std::uint8_t>(v[3]) : 255);
+            return true;
+        }
+        if (key == "scale") {
+            if (n != 2) return false;
+            e.scale = {v[0], v[1]};
+            return true;
+        }
+        if (key == "wobble") {
+            if (n != 2) return false;
+            e.wobble = v[0];
+            e.wobbleFreq = v[1];
+            return true;
+        }
+        if (key == "burst") {
+            if (n != 5 || !isCount(v[1]) || !(v[3] > 0.f)) return false;
+            burst = {v[0], static_cast<int>(v[1]), v[2], v[3], v[4]};
+            return true;
+        }
+        if (n != 1) return false;
+        if ((key == "count" || key == "jitter" || key == "gap") && !isCount(v[0])) return false;
+        if ((key == "delay" || key == "warn") && !isDuration(v[0])) return false;
+        if (key == "period" && !(v[0] > 0.f && v[0] <= kMaxSeconds)) return false;
+        if (key == "life" && !(v[0] <= kMaxSeconds)) return false; // negative: never expires
+        if (key == "radius" && !(v[0] >= 0.f)) return false;
+        if (key == "delay") e.delay = v[0];
+        else if (key == "period") e.period = v[0];
+        else if (key == "count") e.count = static_cast<int>(v[0]);
+        else if (key == "step") e.step = v[0];
+        else if (key == "spin") e.spin = v[0];
+        else if (key == "speed") e.speed = v[0];
+        else if (key == "jitter") e.jitter = static_cast<int>(v[0]);
+        else if (key == "radius") e.radius = v[0];
+        else if (key == "life") e.life = v[0];
+        else if (key == "gap") e.gap = v[0];
+        else if (key == "random") e.randomAngle = v[0] != 0.f;
+        else if (key == "from") e.from = v[0];
+        else if (key == "to") e.to = v[0];
+        else if (key == "spacing") e.spacing = std::max(1.f, v[0]);
+        else if (key == "sweep") e.sweep = v[0];
+        else if (key == "warn") e.warn = v[0];
+        else return false;
+        return true;
+    }
+
+    std::vector<PatternDef> patterns;
+    std::uint64_t textHash = 0xcbf29ce484222325ull;
+};
+
+// --- Pattern Runner ---
+// Plays one pattern: advances every emitter's cadence and rotation and
+// writes each volley straight into the bullet pool's arrays (or, for beam
+// emitters, the beam pool).
+struct EmitContext {
+    BulletPool& bullets;
+    BeamPool& beams;
+    Rng& rng;
+    sf::Vector2f boss, player;
+    sf::Vector2f arenaSize;
+    const sf::Vector2f* towers;
+    int towerCount;
+    float tickRate;
+    int density;
+};
+
+struct PatternRunner {
+    struct EmitterState {
+        int timer = 0;
+        float rotation = 0.f;
+    };
+
+    int pattern = -1; // index into the library, -1 when idle
+    int elapsed = 0;
+    std::array<EmitterState, PatternDef::kMaxEmitters> states{};
+
+    void start(int patternIndex) {
+        pattern = patternIndex;
+        elapsed = 0;
+        states.fill({});
+    }
+    void stop() { pattern = -1; }
+    bool active() const { return pattern >= 0; }
+
+    void tick(const PatternLibrary& library, EmitContext& ctx) {
+        if (!active()) return;
+        const PatternDef& def = library[pattern];
+        ++elapsed;
+        for (std::size_t k = 0; k < def.emitters.size(); ++k) {
+            const EmitterDef& e = def.emitters[k];
+            EmitterState& s = states[k];
+            ++s.timer;
+            int first = ticks(e.delay, ctx.tickRate), period = ticks(e.period, ctx.tickRate);
+            if (s.timer < first || (s.timer - first) % period != 0) continue;
+            s.rotation += e.spin;
+            if (e.kind == EmitterKind::Beams) fireBeams(e, s, static_cast<std::uint8_t>(k), ctx);
+            else fire(e, s, ctx);
+        }
+    }
+
+    static int ticks(float seconds, float tickRate) { return std::max(1, static_cast<int>(std::lround(seconds * tickRate))); }
+
+private:
+    void fireBeams(const EmitterDef& e, const EmitterState& s, std::uint8_t emitter, EmitContext& ctx) const {
+        ctx.beams.removeEmitter(emitter);
+        Beam b;
+        b.sweep = e.sweep / ctx.tickRate;
+        b.from = e.from;
+        b.to = e.to;
+        b.radius = e.radius;
+        b.warmup = e.warn > 0.f ? ticks(e.warn, ctx.tickRate) : 0;
+        b.life = e.life > 0.f ? b.warmup + ticks(e.life, ctx.tickRate) : -1;
+        b.color = e.color;
+        b.emitter = emitter;
+        int origins = e.origin == EmitterOrigin::Towers ? ctx.towerCount : 1;
+        for (int o = 0; o < origins; ++o) {
+            b.followBoss = e.origin == EmitterOrigin::Boss;
+            b.origin = b.followBoss ? ctx.boss : ctx.towers[o];
+            for (int i = 0; i < e.count; ++i) {
+                b.angle = s.rotation + i * e.step;
+                ctx.beams.add(b);
+            }
+        }
+    }
+
+    void fire(const EmitterDef& e, const EmitterState& s, EmitContext& ctx) const {
+        BulletPool& pool = ctx.bullets;
+        const std::size_t first = pool.size();
+        const std::size_t room = pool.grow(static_cast<std::size_t>(e.volleySize(ctx.towerCount)) * ctx.density);
+        const float frameScale = 60.f / ctx.tickRate;
+        std::size_t n = 0;
+
+        // Directions come from the compile-time tables, turned by one
+        // Rotation per volley; only non-whole angles and wobble need trig.
+        // Extra density copies fan out inside a 10 degree cone, each turned
+        // one more cone step from the last.
+        const Rotation cone(10.f / ctx.density);
+        auto putDir = [&](sf::Vector2f pos, Direction d, float speed) {
+            float v = speed * frameScale;
+            for (int rep = 0; rep < ctx.density && n < room; ++rep) {
+                std::size_t i = first + n++;
+                pool.x[i] = pool.startX[i] = pos.x;
+                pool.y[i] = pool.startY[i] = pos.y;
+                pool.vx[i] = d.x * v;
+                pool.vy[i] = d.y * v;
+                d = cone.apply(d);
+            }
+        };
+        auto put = [&](sf::Vector2f pos, float angle, float speed) { putDir(pos, unitDirection(angle), speed); };
+        const Direction* ring = ringDirections(e.count, e.step);
+        auto ringDir = [&](int i) { return ring ? ring[i] : unitDirection(i * e.step); };
+        auto aimAngle = [&](sf::Vector2f from) {
+            sf::Vector2f d = ctx.player - from;
+            return std::atan2(d.y, d.x) * 180.f / PI;
+        };
+
+        switch (e.kind) {
+            case EmitterKind::Ring: {
+                int origins = e.origin == EmitterOrigin::Towers ? ctx.towerCount : 1;
+                for (int o = 0; o < origins; ++o) {
+                    sf::Vector2f pos = e.origin == EmitterOrigin::Towers ? ctx.towers[o] : ctx.boss;
+                    float base = e.randomAngle ? static_cast<float>(ctx.rng.below(360)) : s.rotation;
+                    Rotation rot(base);
+                    for (int i = 0; i < e.count; ++i) {
+                        if (e.wobble != 0.f) {
+                            float w = std::sin(elapsed / ctx.tickRate * e.wobbleFreq + i) * e.wobble;
+                            put(pos, base + i * e.step + w, e.speed);
+                        } else {
+                            putDir(pos, rot.apply(ringDir(i)), e.speed);
+                        }
+                    }
+                }
+                break;
+            }
+            case EmitterKind::Fan: {
+                Rotation rot(aimAngle(ctx.boss) + s.rotation);
+                for (int i = 0; i < e.count; ++i) putDir(ctx.boss, rot.apply(unitDirection((i - (e.count - 1) * 0.5f) * e.step)), e.speed);
+                break;
+            }
+            case EmitterKind::GapRing: {
+                float aP = aimAngle(ctx.boss);
+                Rotation rot(s.rotation);
+                for (int i = 0; i < e.count; ++i) {
+                    float a = s.rotation + i * e.step;
+                    if (std::abs(std::fmod(a - aP + 540.f, 360.f) - 180.f) > e.gap) putDir(ctx.boss, rot.apply(ringDir(i)), e.speed);
+                }
+                break;
+            }
+            case EmitterKind::Rain: {
+                Direction down = unitDirection(90.f + s.rotation);
+                for (int i = 0; i < e.count; ++i) {
+                    float x = static_cast<float>(ctx.rng.below(static_cast<int>(ctx.arenaSize.x)));
+                    float speed = e.speed + (e.jitter > 0 ? ctx.rng.below(e.jitter) : 0);
+                    putDir({x, -20.f}, down, speed);
+                }
+                break;
+            }
+            case EmitterKind::Wall: {
+                int gapCount = static_cast<int>(e.gap);
+                int gapStart = e.count > gapCount ? ctx.rng.below(e.count - gapCount) : 0;
+                float left = ctx.arenaSize.x / 2.f - e.count * e.step / 2.f;
+                Direction down = unitDirection(90.f + s.rotation);
+                for (int i = 0; i < e.count; ++i) {
+                    if (i >= gapStart && i < gapStart + gapCount) continue;
+                    putDir({left + i * e.step, ctx.boss.y}, down, e.speed);
+                }
+                break;
+            }
+            case EmitterKind::Spokes: {
+                Rotation rot(s.rotation);
+                int steps = e.spokeSteps();
+                for (int i = 0; i < e.count; ++i) {
+                    Direction dir = rot.apply(ringDir(i));
+                    for (int k = 0; k < steps; ++k) {
+                        float d = e.from + k * e.spacing;
+                        putDir(ctx.boss + sf::Vector2f(dir.x, dir.y) * d, dir, e.speed);
+                    }
+                }
+                break;
+            }
+            case EmitterKind::Beams: break; // handled by fireBeams()
+            case EmitterKind::Edges: {
+                sf::Vector2f spawns[4];
+                spawns[0] = {0.f, static_cast<float>(ctx.rng.below(static_cast<int>(ctx.arenaSize.y)))};
+                spawns[1] = {ctx.arenaSize.x, static_cast<float>(ctx.rng.below(static_cast<int>(ctx.arenaSize.y)))};
+                spawns[2] = {static_cast<float>(ctx.rng.below(static_cast<int>(ctx.arenaSize.x))), 0.f};
+                spawns[3] = {static_cast<float>(ctx.rng.below(static_cast<int>(ctx.arenaSize.x))), ctx.arenaSize.y};
+                const float angles[] = {0.f, 180.f, 90.f, 270.f};
+                for (int k = 0; k < 4; ++k) put(spawns[k], angles[k], e.speed);
+                break;
+            }
+        }
+
+        pool.truncate(first + n);
+        float life = e.life > 0.f ? static_cast<float>(ticks(e.life, ctx.tickRate)) : -1.f;
+        pool.fill(first, first + n, e.radius, e.scale, e.color, e.flags, life);
+    }
+};
@@ -0,0 +1,146 @@
+#pragma once
+#include "RenderSnapshot.hpp"
+#include "Replay.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// --- Triple Buffer ---
+// One writer and one reader exchange whole values without locks or waiting.
+// The writer fills its private slot and publish() swaps it with the shared
+// middle slot; the reader's acquire() swaps the middle slot in when it is
+// newer. Each side always owns one slot outright, so neither ever blocks
+// the other and the reader always sees the latest complete value.
+template <typename T>
+class TripleBuffer {
+public:
+    // Lets callers size every slot up front, e.g. reserve vectors.
+    template <typename Fn>
+    void forEachSlot(const Fn& fn) {
+        for (T& slot : slots) fn(slot);
+    }
+
+    T& writeSlot() { return slots[back]; }
+    void publish() { back = middle.exchange(back | kFresh, std::memory_order_acq_rel) & kIndex; }
+
+    // Returns true when a newer value was published since the last call.
+    bool acquire() {
+        if (!(middle.load(std::memory_order_relaxed) & kFresh)) return false;
+        front = middle.exchange(front, std::memory_order_acq_rel) & kIndex;
+        return true;
+    }
+    const T& read() const { return slots[front]; }
+
+private:
+    static constexpr unsigned kIndex = 3, kFresh = 4;
+
+    std::array<T, 3> slots;
+    unsigned back = 0, front = 1;
+    std::atomic<unsigned> middle{2};
+};
+
+// --- Input Queue ---
+// Carries input from the window thread, which owns the keyboard, mouse and
+// events, to the simulation thread. Held buttons and the aim point are
+// state, so each tick takes the newest sample; a restart request is an
+// event, so it stays queued until exactly one tick has consumed it.
+class InputQueue {
+public:
+    void push(const InputFrame& input) {
+        std::lock_guard<std::mutex> lock(mutex);
+        latest = input;
+        restartPending = restartPending || input.restart;
+    }
+
+    InputFrame next() {
+        std::lock_guard<std::mutex> lock(mutex);
+        InputFrame input = latest;
+        input.restart = restartPending;
+        restartPending = false;
+        return input;
+    }
+
+private:
+    std::mutex mutex;
+    InputFrame latest;
+    bool restartPending = false;
+};
+
+// --- Simulation Thread ---
+// Runs the fixed-step loop on its own thread: takes input from the queue,
+// steps the World at its tick rate and publishes a RenderSnapshot after
+// every batch of ticks. While it runs, nothing else may touch the World.
+class SimulationThread {
+public:
+    SimulationThread(World& world, InputQueue& input, TripleBuffer<RenderSnapshot>& output, ReplayRecorder& recorder, int maxStepsPerFrame)
+        : world(world), input(input), output(output), recorder(recorder), maxSteps(maxStepsPerFrame) {
+        output.forEachSlot([&](RenderSnapshot& s) {
+            s.reserve(world);
+            s.capture(world, 0);
+        });
+    }
+
+    ~SimulationThread() { stop(); }
+
+    SimulationThread(const SimulationThread&) = delete;
+    SimulationThread& operator=(const SimulationThread&) = delete;
+
+    void start() {
+        running = true;
+        thread = std::thread([this] { loop(); });
+    }
+
+    void stop() {
+        running = false;
+        if (thread.joinable()) thread.join();
+    }
+
+    static std::uint64_t now() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+private:
+    void loop() {
+        using Clock = std::chrono::steady_clock;
+        const auto tickDuration = std::chrono::duration_cast<Clock::duration>(std::chrono::duration<float>(world.tickDt));
+        auto nextTick = Clock::now();
+        std::uint64_t tick = 0;
+        while (running) {
+            std::this_thread::sleep_until(nextTick);
+            int steps = 0;
+            {
+                PROFILE_ZONE("sim");
+                // Catch up on missed ticks, but past maxSteps a hitch slows
+                // the game down instead of spiralling.
+                while (Clock::now() >= nextTick && steps < maxSteps) {
+                    InputFrame in = input.next();
+                    recorder.record(in);
+                    world.step(in);
+                    nextTick += tickDuration;
+                    ++tick;
+                    ++steps;
+                }
+                if (steps == maxSteps) nextTick = std::max(nextTick, Clock::now());
+            }
+            if (steps == 0) continue;
+            RenderSnapshot& snapshot = output.writeSlot();
+            snapshot.capture(world, tick);
+            snapshot.publishedAt = now();
+            output.publish();
+        }
+    }
+
+    World& world;
+    InputQueue& input;
+    TripleBuffer<RenderSnapshot>& output;
+    ReplayRecorder& recorder;
+    int maxSteps;
+    std::atomic<bool> running{false};
+    std::thread thread;
+};
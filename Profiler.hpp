@@ -0,0 +1,245 @@
+#pragma once
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// --- Profiler ---
+// Scoped-zone timing for the hot path, compiled in only with
+// ENABLE_PROFILER (make PROFILE=1). Without it PROFILE_ZONE and
+// PROFILE_COUNT expand to nothing and no profiler code runs.
+//
+//   PROFILE_ZONE("collide");              // times the rest of the scope
+//   PROFILE_COUNT("bullets removed", n);  // adds n to this frame's counter
+//
+// Each thread writes finished zones into its own fixed ring; the only
+// synchronisation is the ring's head/tail pair. Once per frame the main
+// thread calls endFrame(), which drains every ring into per-zone totals, a
+// rolling frame-time history and, while capturing, a Chrome trace
+// (chrome://tracing or ui.perfetto.dev).
+
+class Profiler {
+public:
+    static constexpr std::size_t kMaxZones = 32;
+    static constexpr std::size_t kMaxCounters = 16;
+    static constexpr std::size_t kHistory = 240; // frames kept for the graph
+
+    struct FrameStats {
+        double frameMs = 0;
+        std::array<double, kMaxZones> zoneMs{};          // summed over threads
+        std::array<std::int64_t, kMaxCounters> counts{};
+    };
+
+    static Profiler& instance() {
+        static Profiler profiler;
+        return profiler;
+    }
+
+    // Registers a zone or counter name once; later calls return the same id.
+    std::uint16_t zone(const char* name) { return lookup(zoneNames, zonesPublished, name, kMaxZones); }
+    std::uint16_t counter(const char* name) { return lookup(counterNames, countersPublished, name, kMaxCounters); }
+
+    // Safe from any thread while others register names: the lists never
+    // reallocate, and a name is counted only once it is fully stored.
+    std::size_t zoneCount() const { return zonesPublished.load(std::memory_order_acquire); }
+    std::size_t counterCount() const { return countersPublished.load(std::memory_order_acquire); }
+    const std::string& zoneName(std::size_t id) const { return zoneNames[id]; }
+    const std::string& counterName(std::size_t id) const { return counterNames[id]; }
+
+    static std::uint64_t now() {
+        return static_cast<std::uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count());
+    }
+
+    void record(std::uint16_t zoneId, std::uint64_t start, std::uint64_t end) { threadLog().push({start, end, zoneId}); }
+    void count(std::uint16_t counterId, std::int64_t n) { counters[counterId].fetch_add(n, std::memory_order_relaxed); }
+
+    // Closes the current frame. Call from one thread only.
+    void endFrame() {
+        std::uint64_t t = now();
+        FrameStats stats;
+        stats.frameMs = lastFrameEnd ? (t - lastFrameEnd) * 1e-6 : 0.0;
+        lastFrameEnd = t;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (const std::unique_ptr<ThreadLog>& log : logs) drain(*log, stats);
+        }
+        for (std::size_t c = 0; c < kMaxCounters; ++c) {
+            stats.counts[c] = counters[c].exchange(0, std::memory_order_relaxed);
+            if (capturing && c < counterCount() && counterSamples.size() < counterSamples.capacity()) counterSamples.push_back({t, static_cast<std::uint16_t>(c), stats.counts[c]});
+        }
+        for (std::size_t z = 0; z < kMaxZones; ++z) average.zoneMs[z] += (stats.zoneMs[z] - average.zoneMs[z]) * 0.1;
+        average.frameMs += (stats.frameMs - average.frameMs) * 0.1;
+        average.counts = stats.counts;
+        history[historyHead] = stats.frameMs;
+        historyHead = (historyHead + 1) % kHistory;
+        last = stats;
+    }
+
+    const FrameStats& lastFrame() const { return last; }
+    const FrameStats& smoothed() const { return average; } // ~10-frame moving average; counts from the last frame
+    // Frame times oldest first; i in [0, kHistory).
+    double frameHistory(std::size_t i) const { return history[(historyHead + i) % kHistory]; }
+
+    // --- Trace capture ---
+    bool isCapturing() const { return capturing; }
+    void startCapture() {
+        traceEvents.clear();
+        counterSamples.clear();
+        traceEvents.reserve(1 << 20);
+        counterSamples.reserve(1 << 14);
+        captureStart = now();
+        capturing = true;
+    }
+    void stopCapture() { capturing = false; }
+
+    // Writes everything captured so far as Chrome trace-event JSON.
+    bool writeTrace(const std::string& path, std::string* error) const {
+        std::FILE* f = std::fopen(path.c_str(), "w");
+        if (!f) {
+            if (error) *error = "cannot write " + path;
+            return false;
+        }
+        std::fprintf(f, "{\"traceEvents\": [\n");
+        bool first = true;
+        auto us = [this](std::uint64_t ns) { return (ns - std::min(ns, captureStart)) / 1000.0; };
+        for (const TraceEvent& e : traceEvents) {
+            std::fprintf(f, "%s{\"name\": \"%s\", \"ph\": \"X\", \"pid\": 1, \"tid\": %u, \"ts\": %.3f, \"dur\": %.3f}",
+                         first ? "" : ",\n", zoneNames[e.zone].c_str(), e.thread, us(e.start), (e.end - e.start) / 1000.0);
+            first = false;
+        }
+        for (const CounterSample& c : counterSamples) {
+            std::fprintf(f, "%s{\"name\": \"%s\", \"ph\": \"C\", \"pid\": 1, \"ts\": %.3f, \"args\": {\"value\": %lld}}",
+                         first ? "" : ",\n", counterNames[c.counter].c_str(), us(c.time), static_cast<long long>(c.value));
+            first = false;
+        }
+        std::fprintf(f, "\n], \"displayTimeUnit\": \"ms\"}\n");
+        bool ok = std::fclose(f) == 0;
+        if (!ok && error) *error = "failed writing " + path;
+        return ok;
+    }
+
+private:
+    struct ZoneEvent {
+        std::uint64_t start, end;
+        std::uint16_t zone;
+    };
+
+    // Single producer (the owning thread), single consumer (endFrame).
+    struct ThreadLog {
+        static constexpr std::size_t kCapacity = 1 << 14;
+        std::array<ZoneEvent, kCapacity> events;
+        std::atomic<std::size_t> head{0}, tail{0};
+        std::uint32_t thread = 0;
+
+        void push(const ZoneEvent& e) {
+            std::size_t h = head.load(std::memory_order_relaxed);
+            if (h - tail.load(std::memory_order_acquire) == kCapacity) return; // full: drop rather than stall
+            events[h % kCapacity] = e;
+            head.store(h + 1, std::memory_order_release);
+        }
+    };
+
+    struct TraceEvent {
+        std::uint64_t start, end;
+        std::uint32_t thread;
+        std::uint16_t zone;
+    };
+
+    struct CounterSample {
+        std::uint64_t time;
+        std::uint16_t counter;
+        std::int64_t value;
+    };
+
+    Profiler() {
+        zoneNames.reserve(kMaxZones);
+        counterNames.reserve(kMaxCounters);
+    }
+
+    std::uint16_t lookup(std::vector<std::string>& names, std::atomic<std::size_t>& published, const char* name, std::size_t limit) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        for (std::size_t i = 0; i < names.size(); ++i) {
+            if (names[i] == name) return static_cast<std::uint16_t>(i);
+        }
+        if (names.size() == limit) return static_cast<std::uint16_t>(limit - 1); // shares the last slot
+        names.emplace_back(name);
+        published.store(names.size(), std::memory_order_release);
+        return static_cast<std::uint16_t>(names.size() - 1);
+    }
+
+    // Allocated on a thread's first zone and kept for the program's life, so
+    // endFrame() never races a thread that has exited.
+    ThreadLog& threadLog() {
+        thread_local ThreadLog* log = nullptr;
+        if (!log) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            logs.push_back(std::make_unique<ThreadLog>());
+            log = logs.back().get();
+            log->thread = static_cast<std::uint32_t>(logs.size());
+        }
+        return *log;
+    }
+
+    void drain(ThreadLog& log, FrameStats& stats) {
+        std::size_t t = log.tail.load(std::memory_order_relaxed), h = log.head.load(std::memory_order_acquire);
+        for (; t != h; ++t) {
+            const ZoneEvent& e = log.events[t % ThreadLog::kCapacity];
+            stats.zoneMs[e.zone] += (e.end - e.start) * 1e-6;
+            if (capturing && traceEvents.size() < traceEvents.capacity()) traceEvents.push_back({e.start, e.end, log.thread, e.zone});
+        }
+        log.tail.store(t, std::memory_order_release);
+    }
+
+    std::mutex registryMutex;
+    std::vector<std::string> zoneNames, counterNames;
+    std::atomic<std::size_t> zonesPublished{0}, countersPublished{0};
+    std::vector<std::unique_ptr<ThreadLog>> logs;
+    std::array<std::atomic<std::int64_t>, kMaxCounters> counters{};
+
+    std::uint64_t lastFrameEnd = 0;
+    FrameStats last, average;
+    std::array<double, kHistory> history{};
+    std::size_t historyHead = 0;
+
+    bool capturing = false;
+    std::uint64_t captureStart = 0;
+    std::vector<TraceEvent> traceEvents;
+    std::vector<CounterSample> counterSamples;
+};
+
+class ProfileScope {
+public:
+    explicit ProfileScope(std::uint16_t zone) : zone(zone), start(Profiler::now()) {}
+    ~ProfileScope() { Profiler::instance().record(zone, start, Profiler::now()); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    std::uint16_t zone;
+    std::uint64_t start;
+};
+
+#define PROFILE_CONCAT_(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_(a, b)
+
+#ifdef ENABLE_PROFILER
+#define PROFILE_ZONE(name)                                                                                  \
+    static const std::uint16_t PROFILE_CONCAT(profileZone_, __LINE__) = Profiler::instance().zone(name);   \
+    ProfileScope PROFILE_CONCAT(profileScope_, __LINE__)(PROFILE_CONCAT(profileZone_, __LINE__))
+#define PROFILE_COUNT(name, n)                                                                 \
+    do {                                                                                       \
+        static const std::uint16_t profileCounter_ = Profiler::instance().counter(name);       \
+        Profiler::instance().count(profileCounter_, static_cast<std::int64_t>(n));              \
+    } while (0)
+#else
+#define PROFILE_ZONE(name) static_cast<void>(0)
+#define PROFILE_COUNT(name, n) static_cast<void>(sizeof(n)) // unevaluated; keeps n's variables "used"
+#endif
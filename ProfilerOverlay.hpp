@@ -0,0 +1,133 @@
+#pragma once
+#include "Profiler.hpp"
+#include <SFML/Graphics.hpp>
+#include <algorithm>
+#include <cctype>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+// --- Profiler Overlay ---
+// Draws the profiler's rolling frame-time graph, per-zone breakdown and
+// counters in one untextured draw call. Text uses a built-in 3x5 pixel font,
+// so the overlay needs no font file.
+class ProfilerOverlay {
+public:
+    bool visible = false;
+
+    void draw(sf::RenderTarget& target, const Profiler& profiler) {
+        if (!visible) return;
+        vertices.clear();
+        const Profiler::FrameStats& avg = profiler.smoothed();
+        const float x0 = 10.f, width = 2.f * Profiler::kHistory;
+        float y = 10.f;
+
+        std::size_t lines = profiler.zoneCount() + profiler.counterCount() + 2;
+        rect({x0 - 6.f, y - 6.f}, {width + 12.f, 90.f + lines * kLine + 12.f}, sf::Color(0, 0, 0, 180));
+
+        char line[64];
+        std::snprintf(line, sizeof line, "FRAME %.2f MS%s", avg.frameMs, profiler.isCapturing() ? "  REC" : "");
+        text({x0, y}, line, sf::Color::White);
+        y += kLine;
+
+        // Frame-time graph; the line marks a 60 Hz budget, bars above it turn red.
+        const float graphH = 70.f, msScale = graphH / 33.3f;
+        rect({x0, y}, {width, graphH}, sf::Color(30, 30, 40, 200));
+        for (std::size_t i = 0; i < Profiler::kHistory; ++i) {
+            float ms = static_cast<float>(profiler.frameHistory(i));
+            float h = std::min(graphH, ms * msScale);
+            sf::Color c = ms > 16.7f ? sf::Color(230, 60, 60) : ms > 8.3f ? sf::Color(230, 200, 60) : sf::Color(80, 200, 90);
+            rect({x0 + 2.f * i, y + graphH - h}, {2.f, h}, c);
+        }
+        rect({x0, y + graphH - 16.7f * msScale}, {width, 1.f}, sf::Color(255, 255, 255, 120));
+        y += graphH + 10.f;
+
+        for (std::size_t z = 0; z < profiler.zoneCount(); ++z) {
+            double ms = avg.zoneMs[z];
+            rect({x0, y}, {6.f, 10.f}, zoneColor(z));
+            std::snprintf(line, sizeof line, "%-14s %6.3f", profiler.zoneName(z).c_str(), ms);
+            text({x0 + 12.f, y}, line, sf::Color::White);
+            float bar = static_cast<float>(ms / std::max(avg.frameMs, 0.001)) * (width - 200.f);
+            rect({x0 + 200.f, y + 2.f}, {std::min(bar, width - 200.f), 6.f}, zoneColor(z));
+            y += kLine;
+        }
+        y += kLine / 2.f;
+        for (std::size_t c = 0; c < profiler.counterCount(); ++c) {
+            std::snprintf(line, sizeof line, "%-18s %lld", profiler.counterName(c).c_str(), static_cast<long long>(avg.counts[c]));
+            text({x0, y}, line, sf::Color(180, 180, 220));
+            y += kLine;
+        }
+
+        sf::View previous = target.getView();
+        target.setView(target.getDefaultView());
+        target.draw(vertices.data(), vertices.size(), sf::PrimitiveType::Triangles);
+        target.setView(previous);
+    }
+
+private:
+    static constexpr float kPixel = 2.f; // font pixel size on screen
+    static constexpr float kLine = 14.f;
+
+    static sf::Color zoneColor(std::size_t z) {
+        static const sf::Color palette[] = {
+            {90, 170, 255}, {255, 150, 60}, {120, 220, 120}, {230, 90, 200},
+            {250, 220, 80}, {100, 220, 220}, {200, 120, 90}, {170, 140, 255},
+        };
+        return palette[z % (sizeof palette / sizeof palette[0])];
+    }
+
+    void rect(sf::Vector2f p, sf::Vector2f size, sf::Color c) {
+        sf::Vector2f q = p + size;
+        vertices.push_back({p, c});
+        vertices.push_back({{q.x, p.y}, c});
+        vertices.push_back({q, c});
+        vertices.push_back({p, c});
+        vertices.push_back({q, c});
+        vertices.push_back({{p.x, q.y}, c});
+    }
+
+    void text(sf::Vector2f p, const char* s, sf::Color c) {
+        for (; *s; ++s, p.x += 4.f * kPixel) {
+            std::uint16_t g = glyph(*s);
+            for (int row = 0; row < 5; ++row) {
+                for (int col = 0; col < 3; ++col) {
+                    if (g & (1u << ((4 - row) * 3 + (2 - col)))) rect({p.x + col * kPixel, p.y + row * kPixel}, {kPixel, kPixel}, c);
+                }
+            }
+        }
+    }
+
+    // Five rows of three bits, top row first, leftmost pixel in the high bit.
+    static constexpr std::uint16_t rows(int a, int b, int c, int d, int e) {
+        return static_cast<std::uint16_t>(a << 12 | b << 9 | c << 6 | d << 3 | e);
+    }
+
+    static std::uint16_t glyph(char ch) {
+        static const std::uint16_t digits[10] = {
+            rows(7,5,5,5,7), rows(2,6,2,2,7), rows(7,1,7,4,7), rows(7,1,7,1,7), rows(5,5,7,1,1),
+            rows(7,4,7,1,7), rows(7,4,7,5,7), rows(7,1,1,2,2), rows(7,5,7,5,7), rows(7,5,7,1,7),
+        };
+        static const std::uint16_t letters[26] = {
+            rows(2,5,7,5,5), rows(6,5,6,5,6), rows(3,4,4,4,3), rows(6,5,5,5,6), rows(7,4,6,4,7),
+            rows(7,4,6,4,4), rows(3,4,5,5,3), rows(5,5,7,5,5), rows(7,2,2,2,7), rows(1,1,1,5,2),
+            rows(5,5,6,5,5), rows(4,4,4,4,7), rows(5,7,7,5,5), rows(6,5,5,5,5), rows(2,5,5,5,2),
+            rows(6,5,6,4,4), rows(2,5,5,6,3), rows(6,5,6,5,5), rows(3,4,2,1,6), rows(7,2,2,2,2),
+            rows(5,5,5,5,7), rows(5,5,5,5,2), rows(5,5,7,7,5), rows(5,5,2,5,5), rows(5,5,2,2,2),
+            rows(7,1,2,4,7),
+        };
+        unsigned char u = static_cast<unsigned char>(ch);
+        if (std::isdigit(u)) return digits[u - '0'];
+        if (std::isalpha(u)) return letters[std::toupper(u) - 'A'];
+        switch (ch) {
+            case '.': return rows(0,0,0,0,2);
+            case ':': return rows(0,2,0,2,0);
+            case '-': return rows(0,0,7,0,0);
+            case '_': return rows(0,0,0,0,7);
+            case '/': return rows(1,1,2,4,4);
+            case '%': return rows(5,1,2,4,5);
+            default: return 0;
+        }
+    }
+
+    std::vector<sf::Vertex> vertices;
+};
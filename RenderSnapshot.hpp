@@ -0,0 +1,58 @@
+#pragma once
+#include "Beam.hpp"
+#include "BulletBatch.hpp"
+#include "World.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// --- Render Snapshot ---
+// Everything a frame draws, copied out of the World after a tick: bullets
+// and beams, boss and player with their previous positions for
+// interpolation, HP fractions, the void walls and the towers. A snapshot
+// never points back into the World, so it can be drawn on one thread while
+// the next tick runs on another.
+struct RenderSnapshot {
+    std::vector<BulletSprite> bullets; // enemy bullets, then the player's
+    BeamPool beams;
+    sf::Vector2f bossPos, prevBossPos, playerPos, prevPlayerPos;
+    sf::Color bossColor = sf::Color::White;
+    float bossHP = 1.f, playerHP = 1.f; // fractions of the maximum
+    float voidLeft = 0.f, voidRight = World::worldW;
+    bool voidActive = false, towersActive = false;
+    bool isGameOver = false, isVictory = false;
+    float tickDt = 1.f / 120.f;
+    std::uint64_t tick = 0;
+    std::uint64_t publishedAt = 0; // steady_clock ns when the tick finished
+
+    // Sized for the world's pools, so capture() does not allocate until the
+    // pools themselves grow.
+    void reserve(const World& world) {
+        bullets.reserve(world.bullets.capacity() + world.playerBullets.capacity());
+        beams = BeamPool(world.beams.capacity());
+    }
+
+    void capture(const World& world, std::uint64_t tickNumber) {
+        bullets.clear();
+        BulletSprite::appendPool(bullets, world.bullets);
+        BulletSprite::appendPool(bullets, world.playerBullets);
+        beams = world.beams;
+        bossPos = world.bossPos;
+        prevBossPos = world.prevBossPos;
+        playerPos = world.playerPos;
+        prevPlayerPos = world.prevPlayerPos;
+        bossColor = world.bossColor;
+        bossHP = std::max(0.f, world.bossCurrentHP / World::bossMaxHP);
+        playerHP = std::max(0.f, world.playerHealth / World::playerMaxHP);
+        voidLeft = world.voidLeft;
+        voidRight = world.voidRight;
+        voidActive = world.voidActive();
+        towersActive = world.towersActive();
+        isGameOver = world.isGameOver;
+        isVictory = world.isVictory;
+        tickDt = world.tickDt;
+        tick = tickNumber;
+    }
+};
@@ -0,0 +1,414 @@
+#pragma once
+#include "World.hpp"
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// --- Replays ---
+// A replay is everything World needs to rerun a fight: the seed, tick rate,
+// density and pattern library, then one InputFrame per tick. Files start
+// with a 48-byte
+// header in host byte order, so a replay plays back on the kind of machine
+// that recorded it:
+//
+//   0  "OSRP"       magic
+//   4  u16 version  kReplayVersion
+//   6  u16 density
+//   8  f32 tickRate
+//   12 u32          reserved, zero
+//   16 u64 seed
+//   24 u64 ticks    filled in when recording stops
+//   32 u64 hash     World::stateHash() after the last tick, or 0
+//   40 u64 patterns PatternLibrary::fingerprint() of the library played
+//
+// followed by records, each covering a run of identical ticks:
+//
+//   u8 tag          bits 0-6 buttons (up, down, left, right, fire, shotgun,
+//                   restart), bit 7 set when the aim moved
+//   [varint dx, dy] aim change in 1/8 px, zigzag encoded, if bit 7 is set
+//   varint repeat   further ticks with the same input
+//
+// Aim points are snapped to the 1/8 px grid before the simulation sees them
+// (see quantizeAim), so what is stored is exactly what was played.
+
+constexpr std::uint16_t kReplayVersion = 2;
+constexpr std::size_t kReplayHeaderSize = 48;
+constexpr float kAimUnitsPerPixel = 8.f;
+
+inline sf::Vector2f quantizeAim(sf::Vector2f aim) {
+    return {std::round(aim.x * kAimUnitsPerPixel) / kAimUnitsPerPixel, std::round(aim.y * kAimUnitsPerPixel) / kAimUnitsPerPixel};
+}
+
+struct ReplayHeader {
+    std::uint16_t version = kReplayVersion;
+    std::uint16_t density = 1;
+    float tickRate = 120.f;
+    std::uint64_t seed = 0;
+    std::uint64_t ticks = 0;
+    std::uint64_t finalHash = 0;
+    std::uint64_t patterns = 0;
+};
+
+namespace replay_detail {
+
+inline void putBytes(unsigned char*& p, const void* v, std::size_t n) { std::memcpy(p, v, n); p += n; }
+
+inline void encodeHeader(const ReplayHeader& h, unsigned char out[kReplayHeaderSize]) {
+    std::uint32_t reserved = 0;
+    unsigned char* p = out;
+    putBytes(p, "OSRP", 4);
+    putBytes(p, &h.version, 2);
+    putBytes(p, &h.density, 2);
+    putBytes(p, &h.tickRate, 4);
+    putBytes(p, &reserved, 4);
+    putBytes(p, &h.seed, 8);
+    putBytes(p, &h.ticks, 8);
+    putBytes(p, &h.finalHash, 8);
+    putBytes(p, &h.patterns, 8);
+}
+
+inline bool decodeHeader(const unsigned char* in, std::size_t size, ReplayHeader& h) {
+    if (size < kReplayHeaderSize || std::memcmp(in, "OSRP", 4) != 0) return false;
+    std::memcpy(&h.version, in + 4, 2);
+    std::memcpy(&h.density, in + 6, 2);
+    std::memcpy(&h.tickRate, in + 8, 4);
+    std::memcpy(&h.seed, in + 16, 8);
+    std::memcpy(&h.ticks, in + 24, 8);
+    std::memcpy(&h.finalHash, in + 32, 8);
+    std::memcpy(&h.patterns, in + 40, 8);
+    return h.version == kReplayVersion;
+}
+
+inline unsigned char* putVarint(unsigned char* p, std::uint32_t v) {
+    while (v >= 0x80) { *p++ = static_cast<unsigned char>(v | 0x80); v >>= 7; }
+    *p++ = static_cast<unsigned char>(v);
+    return p;
+}
+
+inline bool getVarint(const unsigned char*& p, const unsigned char* end, std::uint32_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 35; shift += 7) {
+        unsigned char b = *p++;
+        v |= static_cast<std::uint32_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+inline std::uint32_t zigzag(std::int32_t v) { return (static_cast<std::uint32_t>(v) << 1) ^ static_cast<std::uint32_t>(v >> 31); }
+inline std::int32_t unzigzag(std::uint32_t v) { return static_cast<std::int32_t>(v >> 1) ^ -static_cast<std::int32_t>(v & 1); }
+
+inline std::uint8_t buttons(const InputFrame& in) {
+    return static_cast<std::uint8_t>(in.up | in.down << 1 | in.left << 2 | in.right << 3 |
+                                     in.fire << 4 | in.shotgun << 5 | in.restart << 6);
+}
+
+inline std::int32_t aimUnits(float v) { return static_cast<std::int32_t>(std::lround(v * kAimUnitsPerPixel)); }
+
+} // namespace replay_detail
+
+// --- Replay Recorder ---
+// record() hands each tick's input to a background thread through a fixed
+// ring buffer; the thread does the encoding and file writes. Nothing on the
+// recording side allocates after open().
+class ReplayRecorder {
+public:
+    ReplayRecorder() : ring(kRingSize) {}
+    ~ReplayRecorder() { close(0); }
+
+    ReplayRecorder(const ReplayRecorder&) = delete;
+    ReplayRecorder& operator=(const ReplayRecorder&) = delete;
+
+    bool isOpen() const { return file != nullptr; }
+
+    bool open(const std::string& path, std::uint64_t seed, float tickRate, int density, const PatternLibrary& patterns, std::string* error) {
+        close(0);
+        if (density < 1 || density > 0xFFFF) {
+            if (error) *error = "density " + std::to_string(density) + " does not fit a replay";
+            return false;
+        }
+        file = std::fopen(path.c_str(), "wb");
+        if (!file) {
+            if (error) *error = "cannot write " + path;
+            return false;
+        }
+        filePath = path;
+        writeFailed = false;
+        header = ReplayHeader{};
+        header.seed = seed;
+        header.tickRate = tickRate;
+        header.density = static_cast<std::uint16_t>(density);
+        header.patterns = patterns.fingerprint();
+        unsigned char bytes[kReplayHeaderSize];
+        replay_detail::encodeHeader(header, bytes);
+        writeFailed = std::fwrite(bytes, 1, sizeof bytes, file) != sizeof bytes;
+
+        head.store(0);
+        tail.store(0);
+        stopping = false;
+        pending = false;
+        writer = std::thread([this] { writerLoop(); });
+        return true;
+    }
+
+    // Call once per simulated tick with the input passed to World::step().
+    // The writer is woken once the ring is half full, so a fast producer
+    // only waits if it outruns a whole ring of encoding.
+    void record(const InputFrame& input) {
+        if (!file) return;
+        std::size_t h = head.load(std::memory_order_relaxed);
+        while (h - tail.load(std::memory_order_acquire) == ring.size()) {
+            wakeWriter(); // full: the writer has fallen a whole ring behind
+            std::this_thread::yield();
+        }
+        ring[h % ring.size()] = input;
+        head.store(h + 1, std::memory_order_release);
+        if (h + 1 - tail.load(std::memory_order_acquire) == ring.size() / 2) wakeWriter();
+    }
+
+    // Flushes everything recorded so far and fills in the header's tick
+    // count and final state hash. Fails if any write along the way did.
+    bool close(std::uint64_t finalHash, std::string* error = nullptr) {
+        if (!file) return true;
+        {
+            std::lock_guard<std::mutex> lock(wakeMutex);
+            stopping = true;
+        }
+        wake.notify_one();
+        writer.join();
+
+        header.finalHash = finalHash;
+        unsigned char bytes[kReplayHeaderSize];
+        replay_detail::encodeHeader(header, bytes);
+        bool ok = !writeFailed && std::fseek(file, 0, SEEK_SET) == 0 && std::fwrite(bytes, 1, sizeof bytes, file) == sizeof bytes;
+        ok = std::fclose(file) == 0 && ok;
+        file = nullptr;
+        if (!ok && error) *error = "failed writing " + filePath;
+        return ok;
+    }
+
+private:
+    static constexpr std::size_t kRingSize = 1 << 12; // 34 s at 120 Hz
+
+    // Taking the mutex after publishing head keeps the writer from missing
+    // the notify between checking its predicate and going to sleep.
+    void wakeWriter() {
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        wake.notify_one();
+    }
+
+    bool dataPending() const {
+        return head.load(std::memory_order_acquire) - tail.load(std::memory_order_relaxed) >= ring.size() / 2;
+    }
+
+    void writerLoop() {
+        for (;;) {
+            bool stop;
+            {
+                std::unique_lock<std::mutex> lock(wakeMutex);
+                wake.wait_for(lock, std::chrono::milliseconds(50), [this] { return stopping || dataPending(); });
+                stop = stopping;
+            }
+            drain();
+            if (stop) break;
+        }
+        if (pending) flushRecord();
+    }
+
+    void drain() {
+        std::size_t t = tail.load(std::memory_order_relaxed), h = head.load(std::memory_order_acquire);
+        for (; t != h; ++t) {
+            const InputFrame& in = ring[t % ring.size()];
+            std::uint8_t b = replay_detail::buttons(in);
+            std::int32_t ax = replay_detail::aimUnits(in.aim.x), ay = replay_detail::aimUnits(in.aim.y);
+            if (pending && b == runButtons && ax == runAimX && ay == runAimY) {
+                ++runRepeat;
+            } else {
+                if (pending) flushRecord();
+                pending = true;
+                runButtons = b;
+                runAimX = ax;
+                runAimY = ay;
+                runRepeat = 0;
+            }
+            ++header.ticks;
+        }
+        tail.store(t, std::memory_order_release);
+    }
+
+    void flushRecord() {
+        unsigned char bytes[16], *p = bytes;
+        bool moved = runAimX != lastAimX || runAimY != lastAimY;
+        *p++ = static_cast<unsigned char>(runButtons | (moved ? 0x80 : 0));
+        if (moved) {
+            p = replay_detail::putVarint(p, replay_detail::zigzag(runAimX - lastAimX));
+            p = replay_detail::putVarint(p, replay_detail::zigzag(runAimY - lastAimY));
+            lastAimX = runAimX;
+            lastAimY = runAimY;
+        }
+        p = replay_detail::putVarint(p, runRepeat);
+        std::size_t n = static_cast<std::size_t>(p - bytes);
+        if (std::fwrite(bytes, 1, n, file) != n) writeFailed = true;
+        pending = false;
+    }
+
+    std::vector<InputFrame> ring;
+    std::atomic<std::size_t> head{0}, tail{0};
+    std::thread writer;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+
+    // Writer thread only, while it runs.
+    std::FILE* file = nullptr;
+    std::string filePath;
+    bool writeFailed = false;
+    ReplayHeader header;
+    bool pending = false;
+    std::uint8_t runButtons = 0;
+    std::int32_t runAimX = 0, runAimY = 0, lastAimX = 0, lastAimY = 0;
+    std::uint32_t runRepeat = 0;
+};
+
+// --- Replay Reader ---
+// Maps the whole file read-only and decodes it one tick at a time.
+class ReplayReader {
+public:
+    ReplayReader() = default;
+    ~ReplayReader() { unmap(); }
+
+    ReplayReader(const ReplayReader&) = delete;
+    ReplayReader& operator=(const ReplayReader&) = delete;
+
+    // Fails unless the replay was recorded with `patterns`, since it would
+    // otherwise only diverge at the end.
+    bool open(const std::string& path, const PatternLibrary& patterns, std::string* error) {
+        unmap();
+        if (!map(path)) {
+            if (error) *error = "cannot map " + path;
+            return false;
+        }
+        if (!replay_detail::decodeHeader(data, size, header)) {
+            if (error) *error = path + ": not a version " + std::to_string(kReplayVersion) + " replay";
+            unmap();
+            return false;
+        }
+        if (header.patterns != patterns.fingerprint()) {
+            if (error) *error = path + ": recorded with a different pattern library (check --patterns)";
+            unmap();
+            return false;
+        }
+        cursor = data + kReplayHeaderSize;
+        repeat = 0;
+        aimX = aimY = 0;
+        current = InputFrame{};
+        return true;
+    }
+
+    const ReplayHeader& info() const { return header; }
+
+    // Next tick's input; false once the stream ends or turns out corrupt.
+    bool next(InputFrame& out) {
+        if (repeat > 0) {
+            --repeat;
+            out = current;
+            return true;
+        }
+        const unsigned char* end = data + size;
+        if (cursor >= end) return false;
+        std::uint8_t tag = *cursor++;
+        if (tag & 0x80) {
+            std::uint32_t dx, dy;
+            if (!replay_detail::getVarint(cursor, end, dx) || !replay_detail::getVarint(cursor, end, dy)) return false;
+            aimX += replay_detail::unzigzag(dx);
+            aimY += replay_detail::unzigzag(dy);
+        }
+        if (!replay_detail::getVarint(cursor, end, repeat)) return false;
+        current.up = tag & 1;
+        current.down = tag & 2;
+        current.left = tag & 4;
+        current.right = tag & 8;
+        current.fire = tag & 16;
+        current.shotgun = tag & 32;
+        current.restart = tag & 64;
+        current.aim = {aimX / kAimUnitsPerPixel, aimY / kAimUnitsPerPixel};
+        out = current;
+        return true;
+    }
+
+private:
+    bool map(const std::string& path) {
+#ifdef _WIN32
+        fileHandle = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+        if (fileHandle == INVALID_HANDLE_VALUE) return false;
+        LARGE_INTEGER length;
+        if (!GetFileSizeEx(fileHandle, &length) || length.QuadPart == 0) return false;
+        size = static_cast<std::size_t>(length.QuadPart);
+        mapping = CreateFileMappingA(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (!mapping) return false;
+        data = static_cast<const unsigned char*>(MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        return data != nullptr;
+#else
+        int fd = ::open(path.c_str(), O_RDONLY);
+        if (fd < 0) return false;
+        struct stat st;
+        if (fstat(fd, &st) != 0 || st.st_size == 0) { ::close(fd); return false; }
+        void* p = mmap(nullptr, static_cast<std::size_t>(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (p == MAP_FAILED) return false;
+        size = static_cast<std::size_t>(st.st_size);
+        madvise(p, size, MADV_SEQUENTIAL);
+        data = static_cast<const unsigned char*>(p);
+        return true;
+#endif
+    }
+
+    void unmap() {
+#ifdef _WIN32
+        if (data) UnmapViewOfFile(data);
+        if (mapping) CloseHandle(mapping);
+        if (fileHandle != INVALID_HANDLE_VALUE) CloseHandle(fileHandle);
+        mapping = nullptr;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (data) munmap(const_cast<unsigned char*>(data), size);
+#endif
+        data = nullptr;
+        size = 0;
+    }
+
+#ifdef _WIN32
+    HANDLE fileHandle = INVALID_HANDLE_VALUE;
+    HANDLE mapping = nullptr;
+#endif
+    const unsigned char* data = nullptr;
+    std::size_t size = 0;
+    const unsigned char* cursor = nullptr;
+    ReplayHeader header;
+    InputFrame current;
+    std::uint32_t repeat = 0;
+    std::int32_t aimX = 0, aimY = 0;
+};
@@ -0,0 +1,21 @@
+#pragma once
+#include <cstdint>
+
+// --- Random Numbers ---
+// splitmix64: tiny, fast and identical on every platform, so a seed fully
+// determines a run.
+struct Rng {
+    std::uint64_t state;
+
+    explicit Rng(std::uint64_t seed = 0) : state(seed) {}
+
+    std::uint32_t next() {
+        std::uint64_t z = (state += 0x9E3779B97F4A7C15ull);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+        return static_cast<std::uint32_t>((z ^ (z >> 31)) >> 32);
+    }
+
+    // Uniform integer in [0, n).
+    int below(int n) { return static_cast<int>(next() % static_cast<std::uint32_t>(n)); }
+};
@@ -0,0 +1,68 @@
+#pragma once
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+// --- Spatial Grid ---
+// Uniform grid broadphase rebuilt from scratch each tick with a counting
+// sort. Each item is filed under the cell holding its centre; queries widen
+// their box by the largest item half size given to build(), so every item
+// that could overlap the box is reported. Items outside the grid clamp to the
+// border cells.
+class SpatialGrid {
+public:
+    SpatialGrid(sf::Vector2f origin, sf::Vector2f size, float cellSize)
+        : origin(origin), invCellSize(1.f / cellSize),
+          cols(static_cast<int>(size.x / cellSize) + 1), rows(static_cast<int>(size.y / cellSize) + 1),
+          cellStart(static_cast<std::size_t>(cols * rows) + 1) {}
+
+    // Makes build() allocation-free for up to n items.
+    void reserve(std::size_t n) {
+        cellOfItem.reserve(n);
+        items.reserve(n);
+        cursor.reserve(cellStart.size());
+    }
+
+    // x and y are parallel arrays of n item centres; itemExtent bounds every
+    // item's half size along either axis.
+    void build(const float* x, const float* y, std::size_t n, float itemExtent) {
+        maxExtent = itemExtent;
+        cellOfItem.resize(n);
+        items.resize(n);
+        std::fill(cellStart.begin(), cellStart.end(), 0u);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint32_t c = cellIndex(column(x[i]), row(y[i]));
+            cellOfItem[i] = c;
+            ++cellStart[c + 1];
+        }
+        for (std::size_t c = 1; c < cellStart.size(); ++c) cellStart[c] += cellStart[c - 1];
+        cursor.assign(cellStart.begin(), cellStart.end() - 1);
+        for (std::size_t i = 0; i < n; ++i) items[cursor[cellOfItem[i]]++] = static_cast<std::uint32_t>(i);
+    }
+
+    // Calls fn(index) for every item whose cell may overlap [min, max].
+    template <typename Fn>
+    void query(sf::Vector2f min, sf::Vector2f max, Fn&& fn) const {
+        int c0 = column(min.x - maxExtent), c1 = column(max.x + maxExtent);
+        int r0 = row(min.y - maxExtent), r1 = row(max.y + maxExtent);
+        for (int r = r0; r <= r1; ++r) {
+            for (int c = c0; c <= c1; ++c) {
+                std::uint32_t cell = cellIndex(c, r);
+                for (std::uint32_t k = cellStart[cell]; k < cellStart[cell + 1]; ++k) fn(items[k]);
+            }
+        }
+    }
+
+private:
+    int column(float px) const { return std::clamp(static_cast<int>((px - origin.x) * invCellSize), 0, cols - 1); }
+    int row(float py) const { return std::clamp(static_cast<int>((py - origin.y) * invCellSize), 0, rows - 1); }
+    std::uint32_t cellIndex(int c, int r) const { return static_cast<std::uint32_t>(r * cols + c); }
+
+    sf::Vector2f origin;
+    float invCellSize;
+    int cols, rows;
+    float maxExtent = 0.f;
+    std::vector<std::uint32_t> cellStart, cursor, cellOfItem, items;
+};
@@ -0,0 +1,649 @@
+#pragma once
+#include "Beam.hpp"
+#include "BulletKernel.hpp"
+#include "BulletPool.hpp"
+#include "Collision.hpp"
+#include "FrameArena.hpp"
+#include "GameMath.hpp"
+#include "JobSystem.hpp"
+#include "Patterns.hpp"
+#include "Profiler.hpp"
+#include "Rng.hpp"
+#include "SpatialGrid.hpp"
+#include <SFML/Graphics/Color.hpp>
+#include <SFML/System/Vector2.hpp>
+#include <algorithm>
+#include <cmath>
+#include <cstdint>
+#include <vector>
+
+// --- Input ---
+// Everything the simulation reads from the player in one tick. The aim point
+// is already in world coordinates.
+struct InputFrame {
+    bool up = false, down = false, left = false, right = false;
+    bool fire = false, shotgun = false;
+    bool restart = false;
+    sf::Vector2f aim;
+};
+
+// --- World ---
+// The whole fight: boss, player, projectiles, pattern state and the RNG.
+// Nothing here touches a window, a clock or global state, so the same seed
+// and the same inputs always produce the same run.
+//
+// The simulation advances in fixed ticks of 1/tickRate seconds. Timers and
+// cooldowns count ticks, and speeds tuned as pixels per 60 Hz frame are
+// rescaled by frameScale, so behaviour does not depend on the tick rate.
+struct World {
+    static constexpr float worldW = 1920.f;
+    static constexpr float worldH = 1080.f;
+    static constexpr float bossMaxHP = 8000.f;
+    static constexpr float playerMaxHP = 1000.f;
+    static constexpr float playerRadius = 15.f;
+    static constexpr sf::Vector2f bossHalfSize{40.f, 40.f};
+    static constexpr sf::Vector2f towerPositions[4] = {{100.f, 100.f}, {worldW - 100.f, 100.f}, {100.f, worldH - 100.f}, {worldW - 100.f, worldH - 100.f}};
+
+    bool isGameOver = false, isVictory = false;
+    float playerHealth = playerMaxHP, bossCurrentHP = bossMaxHP;
+    int bossTimer = 0, patternTimer = 0, warningTimer = 0, survivalTimer = 0;
+    int sinceHit = 0, sinceShot = 0, sinceShotgun = 0;
+    bool isWarning = false, isSurvival = false, isSurvivalWarning = false;
+    int currentPhase = 1, nextThreshold = 1;
+
+    sf::Vector2f playerPos, bossPos;
+    sf::Vector2f prevPlayerPos, prevBossPos; // as of the previous tick, for render interpolation
+    sf::Color bossColor = sf::Color::White;
+    float voidLeft = 0.f, voidRight = worldW;
+
+    // Phase 4 orbits a point that eases toward the player. It starts at the
+    // boss on the fight's first phase 4 tick and carries over into later
+    // phase 4 spells, as the original's function-static did.
+    sf::Vector2f chaseCenter;
+    bool chaseStarted = false;
+
+    // Attack phases 1-6 and survivals 1-3 play these library patterns.
+    static constexpr const char* attackPatternNames[6] = {"spiral", "rain", "gaps", "cross", "shotgun", "stream"};
+    static constexpr const char* survivalPatternNames[3] = {"knife_wall", "dense_cross", "miasma_towers"};
+    PatternLibrary patterns;
+    PatternRunner runner;
+
+    // Tooling overrides: hold the current pattern forever, ignore damage to
+    // both sides, emit every pattern bullet `density` times (set it through
+    // setPatterns()), and pick the bullet kernel's instruction set.
+    bool lockPattern = false, invulnerable = false;
+    int density = 1;
+    KernelIsa kernelIsa = bestKernelIsa();
+
+    // Load shedding, switched on by the game's frame governor: cull bullets
+    // that have left the arena for good instead of at the margin, and skip
+    // shards that could never enter it. Bullets fly in straight lines, so
+    // neither can touch the player; poprocks are kept, since their shards
+    // might come back. Only stateHash() (and, with a full pool, which later
+    // spawns still fit) sees the difference. The shipped patterns burst
+    // their poprocks well inside the arena, so shedShards drops nothing
+    // with them.
+    bool shedOffscreen = false, shedShards = false;
+
+    float tickRate, tickDt, frameScale;
+
+    BulletPool bullets;
+    BulletPool playerBullets;
+    BeamPool beams;
+    Rng rng;
+
+    explicit World(std::uint64_t seed, std::size_t bulletCapacity = BulletPool::kDefaultCapacity, float tickRate = 120.f)
+        : tickRate(tickRate), tickDt(1.f / tickRate), frameScale(60.f / tickRate),
+          bullets(bulletCapacity), playerBullets(512), rng(seed),
+          playerBulletGrid({0.f, 0.f}, {worldW, worldH}, 64.f), workerScratch(1) {
+        reservePatterns();
+        reset();
+    }
+
+    // Swaps in a pattern library and density and restarts the fight.
+    // Allocates: call between ticks only.
+    void setPatterns(const PatternLibrary& library, int emitDensity) {
+        patterns = library;
+        density = emitDensity;
+        reservePatterns();
+        reset();
+    }
+
+    // Spreads the enemy bullet update over worker threads when set. Not
+    // owned; results are identical with or without it. Sizes the per-worker
+    // scratch here, so ticks never have to.
+    void setJobs(JobSystem* js) {
+        jobs = js;
+        workerScratch.resize(jobs ? jobs->workerCount() : 1);
+        reserveScratch();
+    }
+
+    // Skips straight to attack phase 1-6 with no warning.
+    void forcePattern(int phase) {
+        reset();
+        currentPhase = phase;
+        startPattern(attackPatternNames[phase - 1]);
+    }
+
+    // Skips straight to survival 1-3 (knife wall, dense cross, miasma).
+    void forceSurvival(int stage) {
+        reset();
+        nextThreshold = stage + 1;
+        isSurvival = true;
+        startPattern(survivalPatternNames[stage - 1]);
+    }
+
+    // Starts a library pattern; storage was sized for it up front. Unknown
+    // names stop all emission.
+    void startPattern(const char* name) {
+        int index = patterns.find(name);
+        if (index < 0) {
+            stopPattern();
+            return;
+        }
+        runner.start(index);
+    }
+
+    // Raises pool capacities, and the per-tick scratch sized from them, to at
+    // least the given counts. Allocates: call between ticks only.
+    void reserveBullets(std::size_t enemy, std::size_t player = 0) {
+        bullets.reserve(enemy);
+        playerBullets.reserve(player);
+        reserveScratch();
+    }
+
+    // Stops emission; beams belong to the pattern and go with it.
+    void stopPattern() {
+        runner.stop();
+        beams.clear();
+    }
+
+    bool isOver() const { return isGameOver || isVictory; }
+    bool voidActive() const { return isSurvival && nextThreshold == 2; }
+    bool towersActive() const { return isSurvival && nextThreshold == 4; }
+
+    // Restarts the fight. The RNG carries on, so a restart inside a run is
+    // still deterministic.
+    void reset() {
+        playerHealth = playerMaxHP;
+        bossCurrentHP = bossMaxHP;
+        bullets.clear();
+        playerBullets.clear();
+
+        bossTimer = patternTimer = warningTimer = survivalTimer = 0;
+        sinceHit = sinceShot = sinceShotgun = 0;
+        isSurvival = isSurvivalWarning = isWarning = isGameOver = isVictory = false;
+        nextThreshold = 1;
+        currentPhase = 1;
+
+        stopPattern();
+        bossColor = sf::Color::White;
+        voidLeft = 0.f;
+        voidRight = worldW;
+
+        playerPos = {worldW/2.f, worldH * 0.8f};
+        bossPos = {worldW/2.f, 200.f};
+        prevPlayerPos = playerPos;
+        prevBossPos = bossPos;
+        chaseCenter = bossPos;
+        chaseStarted = false;
+        startPattern(attackPatternNames[currentPhase - 1]);
+    }
+
+    // Whole number of ticks closest to a duration in seconds (at least one).
+    int ticks(float seconds) const { return std::max(1, static_cast<int>(std::lround(seconds * tickRate))); }
+    float seconds(int tickCount) const { return tickCount * tickDt; }
+
+    // Per-tick factor for an exponential ease tuned as a fraction per 60 Hz frame.
+    float easing(float perFrame) const { return 1.f - std::pow(1.f - perFrame, frameScale); }
+
+    void step(const InputFrame& input) {
+        if (isOver()) {
+            prevPlayerPos = playerPos;
+            prevBossPos = bossPos;
+            if (input.restart) reset();
+            return;
+        }
+        beginTick(input);
+        spawnBullets();
+        integrateBullets();
+        cullBullets();
+        resolveCollisions();
+        endTick();
+    }
+
+    // Timers, phase changes, boss and player: everything before the bullets.
+    void beginTick(const InputFrame& input) {
+        frameArena.reset();
+        ++sinceHit;
+        ++sinceShot;
+        ++sinceShotgun;
+
+        prevPlayerPos = playerPos;
+        prevBossPos = bossPos;
+        {
+            PROFILE_ZONE("boss");
+            updatePhase();
+            updateBoss();
+        }
+        PROFILE_ZONE("player");
+        updatePlayer(input, prevPlayerPos);
+    }
+
+    void endTick() {
+        if (invulnerable) {
+            playerHealth = playerMaxHP;
+            bossCurrentHP = bossMaxHP;
+        }
+        if (playerHealth <= 0) isGameOver = true;
+        if (bossCurrentHP <= 0) isVictory = true;
+    }
+
+    void updatePhase() {
+        if (lockPattern) return;
+        if (!isSurvival && !isSurvivalWarning && (bossCurrentHP/bossMaxHP) < (1.0f - (nextThreshold * 0.3f))) {
+            isSurvivalWarning = true;
+            warningTimer = 0;
+            bullets.clear();
+            stopPattern();
+        }
+
+        if (!isSurvival && !isSurvivalWarning) {
+            ++patternTimer;
+            float dur = (currentPhase == 6) ? 6.f : 8.f;
+            if (patternTimer >= ticks(dur)) {
+                isWarning = true;
+                warningTimer = 0;
+                stopPattern();
+
+                int nextP;
+                do {
+                    nextP = rng.below(6) + 1;
+                } while (nextP == currentPhase);
+
+                currentPhase = nextP;
+                patternTimer = 0;
+            }
+        }
+    }
+
+    // --- BOSS STATE & MOVEMENT ---
+    void updateBoss() {
+        sf::Vector2f bPos = bossPos;
+        if (isSurvivalWarning) {
+            ++warningTimer;
+            bossColor = static_cast<int>(seconds(warningTimer) * 15) % 2 == 0 ? sf::Color::Blue : sf::Color::Black;
+            sf::Vector2f target = (nextThreshold == 1) ? sf::Vector2f(worldW/2.f, 150.f) : sf::Vector2f(worldW/2.f, worldH/2.f);
+            bossPos += (target - bPos) * easing(0.05f);
+
+            if (warningTimer >= ticks(2.0f)) {
+                isSurvivalWarning = false;
+                isSurvival = true;
+                survivalTimer = 0;
+                nextThreshold++;
+                startPattern(survivalPatternNames[nextThreshold - 2]);
+            }
+        } else if (isSurvival) {
+            ++survivalTimer;
+            bossColor = nextThreshold == 4 ? sf::Color(255, 69, 0) : sf::Color::Blue;
+            sf::Vector2f target = (nextThreshold == 2) ? sf::Vector2f(worldW/2.f, 150.f) : sf::Vector2f(worldW/2.f, worldH/2.f);
+            bossPos += (target - bPos) * easing(0.05f);
+
+            if (survivalTimer >= ticks(15.0f) && !lockPattern) {
+                isSurvival = false;
+                isWarning = true;
+                warningTimer = 0;
+                bullets.clear();
+                stopPattern();
+            }
+        } else if (isWarning) {
+            ++warningTimer;
+            sf::Color tc;
+            if (currentPhase == 1) tc = sf::Color::Magenta;
+            else if (currentPhase == 2) tc = sf::Color::Yellow;
+            else if (currentPhase == 3) tc = sf::Color::Green;
+            else if (currentPhase == 4) tc = sf::Color::Red;
+            else if (currentPhase == 5) tc = sf::Color::White;
+            else tc = sf::Color(255, 128, 0);
+
+            bossColor = static_cast<int>(seconds(warningTimer) * 12) % 2 == 0 ? sf::Color::White : tc;
+
+            sf::Vector2f sp = (currentPhase == 2) ? sf::Vector2f(worldW/2.f, 200.f) :
+                              (currentPhase == 3) ? sf::Vector2f(worldW/2.f+400.f, worldH/2.f) :
+                              (currentPhase == 6) ? sf::Vector2f(worldW-100.f, worldH/2.f) :
+                              sf::Vector2f(worldW/2.f, worldH/2.f);
+            bossPos += (sp - bPos) * easing(0.08f);
+
+            if (warningTimer >= ticks(2.0f)) {
+                isWarning = false;
+                bossTimer = 0;
+                startPattern(attackPatternNames[currentPhase - 1]);
+            }
+        } else {
+            ++bossTimer;
+            float t = seconds(bossTimer);
+            if (currentPhase == 1 || currentPhase == 5) {
+                bossPos += (sf::Vector2f(worldW/2.f, worldH/2.f) - bPos) * easing(0.05f);
+            }
+            else if (currentPhase == 2) {
+                bossPos = {worldW/2.f + std::cos(t) * 600.f, 200.f + std::sin(t * 2.f) * 100.f};
+            }
+            else if (currentPhase == 3) {
+                float a = t * 1.25f;
+                bossPos = {worldW/2.f + std::cos(a) * 400.f, worldH/2.f + std::sin(a) * 400.f};
+            }
+            else if (currentPhase == 4) {
+                if (!chaseStarted) {
+                    chaseCenter = bossPos;
+                    chaseStarted = true;
+                }
+                chaseCenter += (playerPos - chaseCenter) * easing(0.015f);
+                bossPos = chaseCenter + sf::Vector2f(std::cos(t * 3.f) * 200.f, std::sin(t * 3.f) * 200.f);
+            }
+            else if (currentPhase == 6) {
+                float a = -t * 0.5f;
+                bossPos = {worldW/2.f + std::cos(a) * (worldW/2.f - 100.f), worldH/2.f + std::sin(a) * (worldH/2.f - 100.f)};
+            }
+        }
+    }
+
+    // --- PLAYER CONTROLS ---
+    // Shots leave from where the player stood at the start of the tick.
+    void updatePlayer(const InputFrame& input, sf::Vector2f shotOrigin) {
+        sf::Vector2f mvt{0.f, 0.f};
+        if (input.up) mvt.y -= 500.f * tickDt;
+        if (input.down) mvt.y += 500.f * tickDt;
+        if (input.left) mvt.x -= 500.f * tickDt;
+        if (input.right) mvt.x += 500.f * tickDt;
+        playerPos += mvt;
+
+        if (input.fire && sinceShot > ticks(0.12f)) {
+            spawnPlayerBullet(shotOrigin, input.aim);
+            sinceShot = 0;
+        }
+
+        if (input.shotgun && sinceShotgun > ticks(0.5f)) {
+            for (int i = 0; i < 360; i += 30) {
+                float r = (float)i * PI / 180.f;
+                spawnPlayerBullet(shotOrigin, shotOrigin + sf::Vector2f(std::cos(r)*100.f, std::sin(r)*100.f));
+            }
+            sinceShotgun = 0;
+        }
+
+        playerPos.x = std::clamp(playerPos.x, playerRadius, worldW - playerRadius);
+        playerPos.y = std::clamp(playerPos.y, playerRadius, worldH - playerRadius);
+    }
+
+    // --- SHOOTING LOGIC ---
+    void spawnBullets() {
+        PROFILE_ZONE("spawn");
+        if (isSurvival && nextThreshold == 2 && runner.active()) { // SURVIVAL 1: KNIFE WALL arena
+            float cHW = patterns[runner.pattern].wallWidth() / 2.f; // the void hugs the wall's row
+            if (cHW > 0.f) {
+                voidLeft = (worldW/2.f) - cHW;
+                voidRight = (worldW/2.f) + cHW;
+
+                if (playerPos.x < voidLeft || playerPos.x > voidRight) playerHealth = 0; // Void Kill
+            }
+        }
+
+        EmitContext ctx{bullets, beams, rng, bossPos, playerPos, {worldW, worldH}, towerPositions, 4, tickRate, density};
+        std::size_t before = bullets.size();
+        runner.tick(patterns, ctx);
+        PROFILE_COUNT("bullets spawned", bullets.size() - before);
+    }
+
+    // --- COLLISION, EXPLOSIONS, CLEANUP ---
+    // Enemy bullets go through the SIMD kernel, which also sorts them into
+    // the exploded/expired/hit/alive masks the next two stages act on. With a
+    // job system the blocks are split across workers, each noting its own
+    // detonations and player hits.
+    void integrateBullets() {
+        PROFILE_ZONE("integrate");
+        playerBullets.integrate();
+        beams.update(bossPos);
+        float burstRange = runner.active() ? patterns[runner.pattern].burst.range : BurstDef{}.range;
+        KernelParams params{-150.f, -150.f, worldW + 150.f, worldH + 150.f, burstRange * burstRange, 850.f * 850.f,
+                            playerPos.x, playerPos.y, playerRadius, playerPos.x - prevPlayerPos.x, playerPos.y - prevPlayerPos.y};
+        if (shedOffscreen) {
+            params.shedMinX = params.shedMinY = 0.f;
+            params.shedMaxX = worldW;
+            params.shedMaxY = worldH;
+        }
+        bulletMasks.resize(bullets.size());
+        for (WorkerScratch& s : workerScratch) {
+            s.detonations = FrameVector<std::uint32_t>(frameArena, bullets.size());
+            s.hits = 0;
+            s.firstHit = kNoHit;
+        }
+
+        auto update = [&](std::size_t firstBlock, std::size_t lastBlock, unsigned worker) {
+            PROFILE_ZONE("kernel chunk");
+            runBulletKernel(kernelIsa, bullets, firstBlock, lastBlock, params, bulletMasks);
+            WorkerScratch& s = workerScratch[worker];
+            for (std::size_t b = firstBlock; b < lastBlock; ++b) {
+                for (unsigned bits = bulletMasks.exploded[b], i = static_cast<unsigned>(b * 8); bits; bits >>= 1, ++i) {
+                    if (bits & 1) s.detonations.push_back(i);
+                }
+                for (unsigned bits = bulletMasks.hit[b], i = static_cast<unsigned>(b * 8); bits; bits >>= 1, ++i) {
+                    if (!(bits & 1)) continue;
+                    ++s.hits;
+                    s.firstHit = std::min(s.firstHit, bulletHitTime(i));
+                }
+            }
+        };
+        if (jobs) jobs->parallelFor(bulletMasks.blocks, kBlocksPerJob, update);
+        else update(0, bulletMasks.blocks, 0);
+    }
+
+    // Merges the workers' detonations back into index order, so shards spawn
+    // exactly as a single thread would spawn them, then compacts away
+    // everything the kernel did not mark alive. Shards land past the masked
+    // range and survive compaction.
+    void cullBullets() {
+        PROFILE_ZONE("cleanup");
+        // Player bullets go once they started the tick outside the arena, so
+        // one that crossed the boss on its way out still gets its swept test.
+        for (std::size_t i = playerBullets.size(); i-- > 0; ) {
+            float x = playerBullets.x[i] - playerBullets.vx[i], y = playerBullets.y[i] - playerBullets.vy[i];
+            if (x < 0 || x > worldW || y < 0 || y > worldH) playerBullets.removeAt(i);
+        }
+        FrameVector<std::uint32_t> detonations(frameArena, bullets.size());
+        bulletHits = 0;
+        firstBulletHit = kNoHit;
+        for (const WorkerScratch& s : workerScratch) {
+            for (std::uint32_t i : s.detonations) detonations.push_back(i);
+            bulletHits += s.hits;
+            firstBulletHit = std::min(firstBulletHit, s.firstHit);
+        }
+        std::sort(detonations.begin(), detonations.end());
+
+        BurstDef burst = runner.active() ? patterns[runner.pattern].burst : BurstDef{};
+        std::size_t n = bullets.size();
+        const Direction* shards = ringDirections(burst.count, burst.step);
+        float shardSpeed = burst.speed * frameScale;
+        for (std::uint32_t i : detonations) {
+            for (int j = 0; j < burst.count; ++j) {
+                Direction d = shards ? shards[j] : unitDirection(j * burst.step);
+                if (shedShards && leavesArena(bullets.position(i), {d.x, d.y}, burst.radius)) continue;
+                bullets.spawnWithVelocity(bullets.position(i), {d.x * shardSpeed, d.y * shardSpeed}, burst.radius, bullets.color[i], BulletPool::Shard);
+            }
+        }
+        std::size_t beforeCompact = bullets.size();
+        bullets.compact(bulletMasks.alive.data(), n);
+        PROFILE_COUNT("bullets spawned", beforeCompact - n);
+        PROFILE_COUNT("bullets removed", beforeCompact - bullets.size());
+    }
+
+    void resolveCollisions() {
+        PROFILE_ZONE("collide");
+        // Player bullets against the boss, both swept along the tick. The
+        // grid holds where the bullets ended up, so the query covers the
+        // boss's path grown by one shot's travel.
+        FrameVector<TimedHit> bossHits(frameArena, playerBullets.size());
+        sf::Vector2f bossMove = bossPos - prevBossPos;
+        sf::Vector2f reach = bossHalfSize + sf::Vector2f(playerShotSpeed, playerShotSpeed) * frameScale;
+        sf::Vector2f lo{std::min(prevBossPos.x, bossPos.x), std::min(prevBossPos.y, bossPos.y)};
+        sf::Vector2f hi{std::max(prevBossPos.x, bossPos.x), std::max(prevBossPos.y, bossPos.y)};
+        playerBulletGrid.build(playerBullets.x.data(), playerBullets.y.data(), playerBullets.size(), playerBullets.maxExtent());
+        playerBulletGrid.query(lo - reach, hi + reach, [&](std::uint32_t i) {
+            sf::Vector2f v{playerBullets.vx[i], playerBullets.vy[i]};
+            float toi = sweptCircleRect(playerBullets.position(i) - v, v, playerBullets.radius[i], prevBossPos, bossMove, bossHalfSize);
+            if (toi < 0.f && circleRect(playerBullets.position(i), playerBullets.radius[i], bossPos, bossHalfSize)) toi = 1.f;
+            if (toi >= 0.f) bossHits.push_back({toi, i});
+        });
+        std::sort(bossHits.begin(), bossHits.end());
+
+        // Enemy bullets touching the player were flagged by the kernel and
+        // already compacted away; beams stay, and count from the end of the
+        // tick. Only the first hit on the player matters: however many land,
+        // and on however many workers, the damage cooldown is checked once.
+        float playerHitAt = firstBulletHit;
+        for (const Beam& b : beams) {
+            if (b.active() && capsuleCircle(b.start(), b.end(), b.radius, playerPos, playerRadius)) {
+                ++bulletHits;
+                playerHitAt = std::min(playerHitAt, 1.f);
+            }
+        }
+
+        // Everything lands in order of impact, shots at the same instant by
+        // index. Once either side is down nothing later counts, so a tick in
+        // which both would fall ends the way it played out.
+        std::size_t next = 0;
+        auto landShots = [&](float until) {
+            for (; next < bossHits.size() && bossHits[next].time <= until; ++next) {
+                if (!isSurvival && playerHealth > 0 && bossCurrentHP > 0) bossCurrentHP -= 15.f;
+            }
+        };
+        if (bulletHits > 0) {
+            landShots(playerHitAt);
+            if (bossCurrentHP > 0 && sinceHit > ticks(0.15f)) { playerHealth -= 10.f; sinceHit = 0; }
+        }
+        landShots(kNoHit);
+
+        FrameVector<std::uint32_t> hits(frameArena, bossHits.size());
+        for (const TimedHit& h : bossHits) hits.push_back(h.index);
+        playerBullets.removeAll(hits.begin(), hits.end());
+        PROFILE_COUNT("bullets collided", hits.size() + bulletHits);
+    }
+
+    // FNV-1a over the complete simulation state, for determinism checks.
+    // Covers every field serializeWorld() packs.
+    std::uint64_t stateHash() const {
+        std::uint64_t h = 0xcbf29ce484222325ull;
+        auto mix = [&](const void* data, std::size_t n) {
+            const unsigned char* p = static_cast<const unsigned char*>(data);
+            for (std::size_t i = 0; i < n; ++i) { h ^= p[i]; h *= 0x100000001b3ull; }
+        };
+        auto mixPool = [&](const BulletPool& pool) {
+            std::size_t n = pool.size();
+            mix(&n, sizeof n);
+            mix(pool.x.data(), n * sizeof(float)); mix(pool.y.data(), n * sizeof(float));
+            mix(pool.vx.data(), n * sizeof(float)); mix(pool.vy.data(), n * sizeof(float));
+            mix(pool.startX.data(), n * sizeof(float)); mix(pool.startY.data(), n * sizeof(float));
+            mix(pool.radius.data(), n * sizeof(float));
+            mix(pool.scaleX.data(), n * sizeof(float)); mix(pool.scaleY.data(), n * sizeof(float));
+            mix(pool.lifeTime.data(), n * sizeof(float)); mix(pool.aliveTime.data(), n * sizeof(float));
+            mix(pool.color.data(), n * sizeof(sf::Color));
+            mix(pool.flags.data(), n);
+        };
+        bool flagsState[] = {isGameOver, isVictory, isWarning, isSurvival, isSurvivalWarning, chaseStarted};
+        float floats[] = {tickRate, playerHealth, bossCurrentHP, playerPos.x, playerPos.y, bossPos.x, bossPos.y,
+                          prevPlayerPos.x, prevPlayerPos.y, prevBossPos.x, prevBossPos.y,
+                          chaseCenter.x, chaseCenter.y, voidLeft, voidRight};
+        int ints[] = {currentPhase, nextThreshold, bossTimer, patternTimer, warningTimer, survivalTimer,
+                      sinceHit, sinceShot, sinceShotgun, runner.pattern, runner.elapsed};
+        mix(flagsState, sizeof flagsState);
+        mix(floats, sizeof floats);
+        mix(ints, sizeof ints);
+        mix(&bossColor, sizeof bossColor);
+        mix(&rng.state, sizeof rng.state);
+        for (const PatternRunner::EmitterState& e : runner.states) {
+            mix(&e.timer, sizeof e.timer);
+            mix(&e.rotation, sizeof e.rotation);
+        }
+        mixPool(bullets);
+        mixPool(playerBullets);
+        for (const Beam& b : beams) {
+            float beamState[] = {b.origin.x, b.origin.y, b.angle, b.sweep, b.from, b.to, b.radius};
+            int beamTicks[] = {b.warmup, b.life, b.age};
+            std::uint8_t beamTail[] = {b.emitter, static_cast<std::uint8_t>(b.followBoss)};
+            mix(beamState, sizeof beamState);
+            mix(beamTicks, sizeof beamTicks);
+            mix(&b.color, sizeof b.color);
+            mix(beamTail, sizeof beamTail);
+        }
+        return h;
+    }
+
+private:
+    // Sizes bullet storage for the largest peak any library pattern expects,
+    // so starting one mid-fight never grows a pool or the frame arena.
+    void reservePatterns() {
+        std::size_t peak = 0;
+        for (int i = 0; i < patterns.size(); ++i) peak = std::max(peak, patterns[i].estimatePeak(4));
+        reserveBullets(peak * density);
+    }
+
+    // Sizes every per-tick buffer for full pools, so no tick ever has to
+    // grow one: the kernel masks and the player bullet grid, plus arena room
+    // for each worker's detonations, the merged list and the player bullet
+    // hits, timed and plain.
+    void reserveScratch() {
+        bulletMasks.reserve(bullets.capacity());
+        playerBulletGrid.reserve(playerBullets.capacity());
+        std::size_t lists = workerScratch.size() + 1;
+        frameArena.reserve((lists * bullets.capacity() + playerBullets.capacity()) * sizeof(std::uint32_t) +
+                           playerBullets.capacity() * sizeof(TimedHit) + 256);
+    }
+
+    // True when a body of the given extent at p, moving along v, is clear of
+    // the arena on some axis and heading further out on it: it never
+    // returns.
+    static bool leavesArena(sf::Vector2f p, sf::Vector2f v, float extent) {
+        return (p.x + extent < 0.f && v.x <= 0.f) || (p.x - extent > worldW && v.x >= 0.f) ||
+               (p.y + extent < 0.f && v.y <= 0.f) || (p.y - extent > worldH && v.y >= 0.f);
+    }
+
+    static constexpr float playerShotSpeed = 15.f; // px per 60 Hz frame
+
+    void spawnPlayerBullet(sf::Vector2f pos, sf::Vector2f target) {
+        sf::Vector2f dir = target - pos;
+        float mag = std::sqrt(dir.x * dir.x + dir.y * dir.y);
+        playerBullets.spawnWithVelocity(pos, (mag != 0) ? (dir / mag) * (playerShotSpeed * frameScale) : sf::Vector2f(0, 0), 5.f, sf::Color::Yellow);
+    }
+
+    // When in the tick, as a fraction, enemy bullet i first touched the
+    // player. The kernel already flagged it; should the exact solve graze
+    // past, it counts from the end of the tick like the old test.
+    float bulletHitTime(std::size_t i) const {
+        sf::Vector2f v{bullets.vx[i], bullets.vy[i]};
+        float toi = sweptEllipseCircle(bullets.position(i) - v, v, bullets.halfSize(i), prevPlayerPos, playerPos - prevPlayerPos, playerRadius);
+        return toi >= 0.f ? toi : 1.f;
+    }
+
+    // A hit at a fraction of the tick; sorts by time, then index.
+    struct TimedHit {
+        float time;
+        std::uint32_t index;
+        bool operator<(const TimedHit& o) const { return time < o.time || (time == o.time && index < o.index); }
+    };
+    static constexpr float kNoHit = 2.f; // later than any hit
+
+    // Per-worker output of integrateBullets(), padded to keep workers off
+    // each other's cache lines.
+    struct alignas(64) WorkerScratch {
+        FrameVector<std::uint32_t> detonations;
+        int hits = 0;
+        float firstHit = kNoHit;
+    };
+    static constexpr std::size_t kBlocksPerJob = 64;
+
+    SpatialGrid playerBulletGrid;
+    BulletMasks bulletMasks;
+    JobSystem* jobs = nullptr;
+    std::vector<WorkerScratch> workerScratch;
+    int bulletHits = 0;
+    float firstBulletHit = kNoHit;
+    FrameArena frameArena; // scratch for the current tick; reset by beginTick()
+};
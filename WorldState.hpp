@@ -0,0 +1,576 @@
+#pragma once
+#include "World.hpp"
+#include <algorithm>
+#include <array>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// --- World State ---
+// Packs the complete simulation state of a World into bytes and back, for
+// rewind, save states and practice runs. Restoring is exact: the restored
+// World has the same stateHash() and plays on exactly as the original.
+//
+// Layout, in host byte order like replays, every field 4-byte aligned:
+//
+//   header:  "OSWS", u16 version, u16 0, u32 enemy bullets, u32 player
+//            bullets, u32 beams, f32 tickRate
+//   scalars: flag bits, health, positions, timers, RNG, emitter states,
+//            then the running pattern by name
+//   bullets: per pool, column by column: f32 x, y, vx, vy, startX, startY,
+//            u32 birth, u8 style
+//   beams:   48 bytes each
+//   styles:  u32 count, then {f32 radius, scaleX, scaleY, lifeTime; u8 r, g,
+//            b, a, flags} per style
+//
+// Everything a volley shares (size, lifetime, colour, kind) is a one-byte
+// index into the style table at the end. Positions stay exact floats, since
+// a rounded position would make a restored run drift from the original.
+// Ages are stored as the pattern tick each bullet was born on, which stays
+// put from tick to tick. Columns keep neighbouring ticks lined up word for
+// word, so velocities, start points, births and styles XOR to zero runs
+// that encodeDelta() packs away, until culling reorders the pool.
+
+constexpr std::uint16_t kWorldStateVersion = 1;
+constexpr std::size_t kMaxWorldStateBytes = std::size_t(1) << 28; // sanity limit when decoding
+
+namespace world_state {
+
+struct Style {
+    float radius, scaleX, scaleY, lifeTime;
+    sf::Color color;
+    std::uint8_t flags;
+
+    bool operator==(const Style& o) const {
+        return radius == o.radius && scaleX == o.scaleX && scaleY == o.scaleY && lifeTime == o.lifeTime && color == o.color && flags == o.flags;
+    }
+};
+
+inline std::size_t padded(std::size_t n) { return (n + 3) & ~std::size_t(3); }
+
+// Fills a byte vector sized up front, so puts are plain copies; grow()
+// extends it for sections whose size is only known once written.
+class Writer {
+public:
+    Writer(std::vector<std::uint8_t>& out, std::size_t size) : out(out) { out.resize(size); }
+
+    template <typename T>
+    void put(const T& v) { putBytes(&v, sizeof v); }
+    void putBytes(const void* p, std::size_t n) {
+        if (n) std::memcpy(skip(n), p, n);
+    }
+    // Zero bytes up to the next multiple of four.
+    void align() { std::memset(skip(padded(at) - at), 0, padded(at) - at); }
+    // Hands out the next n bytes for the caller to fill.
+    std::uint8_t* skip(std::size_t n) {
+        std::uint8_t* p = out.data() + at;
+        at += n;
+        return p;
+    }
+    void grow(std::size_t n) { out.resize(out.size() + n); }
+
+private:
+    std::vector<std::uint8_t>& out;
+    std::size_t at = 0;
+};
+
+class Reader {
+public:
+    Reader(const std::uint8_t* data, std::size_t n) : begin(data), p(data), end(data + n) {}
+
+    template <typename T>
+    bool get(T& v) { return getBytes(&v, sizeof v); }
+    bool getBytes(void* dst, std::size_t n) {
+        if (static_cast<std::size_t>(end - p) < n) return false;
+        if (n) std::memcpy(dst, p, n);
+        p += n;
+        return true;
+    }
+    bool align() {
+        std::size_t at = static_cast<std::size_t>(p - begin), gap = padded(at) - at;
+        if (static_cast<std::size_t>(end - p) < gap) return false;
+        p += gap;
+        return true;
+    }
+    bool done() const { return p == end; }
+
+private:
+    const std::uint8_t* begin;
+    const std::uint8_t* p;
+    const std::uint8_t* end;
+};
+
+constexpr std::size_t kHeaderBytes = 24;
+constexpr std::size_t kScalarBytes = 4 + 14 * 4 + 10 * 4 + 4 + 8 + PatternDef::kMaxEmitters * 8 + 4; // up to the pattern name
+constexpr std::size_t kBytesPerBullet = 7 * 4 + 1;
+constexpr std::size_t kBytesPerBeam = 48;
+constexpr std::size_t kBytesPerStyle = 24;
+
+} // namespace world_state
+
+// Replaces out with the packed state of `world`. Fails only when bullets
+// use more than 256 distinct styles.
+inline bool serializeWorld(const World& world, std::vector<std::uint8_t>& out, std::string* error = nullptr) {
+    using namespace world_state;
+    const BulletPool* pools[2] = {&world.bullets, &world.playerBullets};
+    const std::string* pattern = world.runner.active() ? &world.patterns[world.runner.pattern].name : nullptr;
+    std::uint32_t nameLength = pattern ? static_cast<std::uint32_t>(pattern->size()) : 0;
+    std::size_t size = kHeaderBytes + kScalarBytes + padded(nameLength) + world.beams.size() * kBytesPerBeam;
+    for (const BulletPool* pool : pools) size += pool->size() * (kBytesPerBullet - 1) + padded(pool->size());
+    Writer w(out, size);
+
+    w.putBytes("OSWS", 4);
+    w.put(kWorldStateVersion);
+    w.put(std::uint16_t(0));
+    for (const BulletPool* pool : pools) w.put(static_cast<std::uint32_t>(pool->size()));
+    w.put(static_cast<std::uint32_t>(world.beams.size()));
+    w.put(world.tickRate);
+
+    std::uint32_t flags = world.isGameOver | world.isVictory << 1 | world.isWarning << 2 | world.isSurvival << 3 | world.isSurvivalWarning << 4 |
+                          world.chaseStarted << 5;
+    float floats[] = {world.playerHealth, world.bossCurrentHP, world.playerPos.x, world.playerPos.y, world.bossPos.x, world.bossPos.y,
+                      world.prevPlayerPos.x, world.prevPlayerPos.y, world.prevBossPos.x, world.prevBossPos.y,
+                      world.chaseCenter.x, world.chaseCenter.y, world.voidLeft, world.voidRight};
+    std::int32_t ints[] = {world.bossTimer, world.patternTimer, world.warningTimer, world.survivalTimer, world.sinceHit,
+                           world.sinceShot, world.sinceShotgun, world.currentPhase, world.nextThreshold, world.runner.elapsed};
+    w.put(flags);
+    w.put(floats);
+    w.put(ints);
+    w.put(world.bossColor);
+    w.put(world.rng.state);
+    for (const PatternRunner::EmitterState& e : world.runner.states) {
+        w.put(e.timer);
+        w.put(e.rotation);
+    }
+    w.put(nameLength);
+    if (pattern) w.putBytes(pattern->data(), nameLength);
+    w.align();
+
+    // Volleys are contiguous, so a bullet's style is nearly always the one
+    // before it.
+    Style styles[256];
+    std::size_t styleCount = 0;
+    for (const BulletPool* pool : pools) {
+        std::size_t n = pool->size();
+        for (const std::vector<float>* column : {&pool->x, &pool->y, &pool->vx, &pool->vy, &pool->startX, &pool->startY}) {
+            w.putBytes(column->data(), n * sizeof(float));
+        }
+        std::uint8_t* births = w.skip(n * sizeof(std::uint32_t));
+        std::uint32_t now = static_cast<std::uint32_t>(world.runner.elapsed);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint32_t birth = now - static_cast<std::uint32_t>(pool->aliveTime[i]);
+            std::memcpy(births + i * sizeof birth, &birth, sizeof birth);
+        }
+        std::uint8_t* index = w.skip(n);
+        std::size_t last = 0;
+        for (std::size_t i = 0; i < n; ++i) {
+            Style s{pool->radius[i], pool->scaleX[i], pool->scaleY[i], pool->lifeTime[i], pool->color[i], pool->flags[i]};
+            if (!(last < styleCount && styles[last] == s)) {
+                last = static_cast<std::size_t>(std::find(styles, styles + styleCount, s) - styles);
+                if (last == styleCount) {
+                    if (styleCount == 256) {
+                        if (error) *error = "more than 256 bullet styles";
+                        return false;
+                    }
+                    styles[styleCount++] = s;
+                }
+            }
+            index[i] = static_cast<std::uint8_t>(last);
+        }
+        w.align();
+    }
+
+    for (const Beam& b : world.beams) {
+        float beamFloats[] = {b.origin.x, b.origin.y, b.angle, b.sweep, b.from, b.to, b.radius};
+        std::int32_t beamInts[] = {b.warmup, b.life, b.age};
+        std::uint8_t tail[] = {b.emitter, static_cast<std::uint8_t>(b.followBoss), 0, 0};
+        w.put(beamFloats);
+        w.put(beamInts);
+        w.put(b.color);
+        w.put(tail);
+    }
+
+    w.grow(4 + styleCount * kBytesPerStyle);
+    w.put(static_cast<std::uint32_t>(styleCount));
+    for (std::size_t k = 0; k < styleCount; ++k) {
+        const Style& s = styles[k];
+        float f[] = {s.radius, s.scaleX, s.scaleY, s.lifeTime};
+        std::uint8_t tail[] = {s.flags, 0, 0, 0};
+        w.put(f);
+        w.put(s.color);
+        w.put(tail);
+    }
+    return true;
+}
+
+// Replaces `world`'s simulation state with a packed one; on failure the
+// World is left untouched. The World keeps its own configuration (patterns,
+// density, job system, kernel). The state must come from the same tick rate
+// and name a pattern the World's library has.
+inline bool deserializeWorld(const std::uint8_t* data, std::size_t size, World& world, std::string* error = nullptr) {
+    using namespace world_state;
+    auto fail = [&](const char* what) {
+        if (error) *error = what;
+        return false;
+    };
+    const char* truncated = "truncated world state";
+    Reader r(data, size);
+    char magic[4];
+    std::uint16_t version = 0, reserved;
+    std::uint32_t counts[3];
+    float tickRate = 0.f;
+    if (!r.getBytes(magic, 4) || std::memcmp(magic, "OSWS", 4) != 0) return fail("not a world state");
+    if (!r.get(version) || version != kWorldStateVersion) return fail("unsupported world state version");
+    if (!r.get(reserved) || !r.get(counts) || !r.get(tickRate)) return fail(truncated);
+    if (tickRate != world.tickRate) return fail("world state was saved at a different tick rate");
+    // Refuse counts the data cannot hold before allocating for them.
+    if ((std::uint64_t(counts[0]) + counts[1]) * kBytesPerBullet + std::uint64_t(counts[2]) * kBytesPerBeam > size) return fail(truncated);
+
+    std::uint32_t flags, nameLength;
+    float floats[14];
+    std::int32_t ints[10];
+    sf::Color bossColor;
+    std::uint64_t rngState;
+    std::array<PatternRunner::EmitterState, PatternDef::kMaxEmitters> states;
+    if (!r.get(flags) || !r.get(floats) || !r.get(ints) || !r.get(bossColor) || !r.get(rngState)) return fail(truncated);
+    for (PatternRunner::EmitterState& e : states) {
+        if (!r.get(e.timer) || !r.get(e.rotation)) return fail(truncated);
+    }
+    if (!r.get(nameLength) || nameLength > size) return fail(truncated);
+    std::string name(nameLength, '\0');
+    if (!r.getBytes(name.data(), nameLength) || !r.align()) return fail(truncated);
+    // Phases and thresholds index the pattern name tables; a survival
+    // warning starts the survival after the current threshold.
+    if (ints[7] < 1 || ints[7] > 6) return fail("bad attack phase in world state");
+    if (ints[8] < 1 || ints[8] > 4 || ((flags & 16) && ints[8] > 3)) return fail("bad survival threshold in world state");
+    int pattern = nameLength ? world.patterns.find(name) : -1;
+    if (nameLength && pattern < 0) return fail("world state uses a pattern this library lacks");
+
+    // Bullets parse into side pools, their style indices parked in the
+    // flags column until the style table at the end has been read.
+    BulletPool parsed[2] = {BulletPool(counts[0]), BulletPool(counts[1])};
+    for (int p = 0; p < 2; ++p) {
+        BulletPool& pool = parsed[p];
+        std::size_t n = pool.grow(counts[p]);
+        for (std::vector<float>* column : {&pool.x, &pool.y, &pool.vx, &pool.vy, &pool.startX, &pool.startY}) {
+            if (!r.getBytes(column->data(), n * sizeof(float))) return fail(truncated);
+        }
+        std::uint32_t now = static_cast<std::uint32_t>(ints[9]);
+        for (std::size_t i = 0; i < n; ++i) {
+            std::uint32_t birth;
+            if (!r.get(birth)) return fail(truncated);
+            pool.aliveTime[i] = static_cast<float>(now - birth);
+        }
+        if (!r.getBytes(pool.flags.data(), n) || !r.align()) return fail(truncated);
+    }
+
+    BeamPool beams(std::max<std::size_t>(world.beams.capacity(), counts[2]));
+    for (std::size_t k = 0; k < counts[2]; ++k) {
+        Beam b;
+        float beamFloats[7];
+        std::int32_t beamInts[3];
+        std::uint8_t tail[4];
+        if (!r.get(beamFloats) || !r.get(beamInts) || !r.get(b.color) || !r.get(tail)) return fail(truncated);
+        b.origin = {beamFloats[0], beamFloats[1]};
+        b.angle = beamFloats[2]; b.sweep = beamFloats[3]; b.from = beamFloats[4]; b.to = beamFloats[5]; b.radius = beamFloats[6];
+        b.warmup = beamInts[0]; b.life = beamInts[1]; b.age = beamInts[2];
+        b.emitter = tail[0];
+        b.followBoss = tail[1] != 0;
+        beams.add(b);
+    }
+
+    std::uint32_t styleCount;
+    Style styles[256];
+    if (!r.get(styleCount) || styleCount > 256) return fail(truncated);
+    for (std::size_t k = 0; k < styleCount; ++k) {
+        float f[4];
+        sf::Color color;
+        std::uint8_t tail[4];
+        if (!r.get(f) || !r.get(color) || !r.get(tail)) return fail(truncated);
+        styles[k] = {f[0], f[1], f[2], f[3], color, tail[0]};
+    }
+    if (!r.done()) return fail("trailing bytes in world state");
+    for (BulletPool& pool : parsed) {
+        for (std::size_t i = 0; i < pool.size(); ++i) {
+            if (pool.flags[i] >= styleCount) return fail("bad bullet style in world state");
+            const Style& s = styles[pool.flags[i]];
+            pool.radius[i] = s.radius; pool.scaleX[i] = s.scaleX; pool.scaleY[i] = s.scaleY;
+            pool.lifeTime[i] = s.lifeTime; pool.color[i] = s.color; pool.flags[i] = s.flags;
+        }
+    }
+
+    World& w = world;
+    w.isGameOver = flags & 1; w.isVictory = flags & 2; w.isWarning = flags & 4; w.isSurvival = flags & 8; w.isSurvivalWarning = flags & 16; w.chaseStarted = flags & 32;
+    w.playerHealth = floats[0]; w.bossCurrentHP = floats[1];
+    w.playerPos = {floats[2], floats[3]}; w.bossPos = {floats[4], floats[5]};
+    w.prevPlayerPos = {floats[6], floats[7]}; w.prevBossPos = {floats[8], floats[9]};
+    w.chaseCenter = {floats[10], floats[11]};
+    w.voidLeft = floats[12]; w.voidRight = floats[13];
+    w.bossTimer = ints[0]; w.patternTimer = ints[1]; w.warningTimer = ints[2]; w.survivalTimer = ints[3];
+    w.sinceHit = ints[4]; w.sinceShot = ints[5]; w.sinceShotgun = ints[6];
+    w.currentPhase = ints[7]; w.nextThreshold = ints[8];
+    w.bossColor = bossColor;
+    w.rng.state = rngState;
+    w.runner.pattern = pattern;
+    w.runner.elapsed = ints[9];
+    w.runner.states = states;
+
+    // Pools only ever grow: the World sized them for its patterns and
+    // density, and its scratch buffers follow their capacity.
+    w.reserveBullets(counts[0], counts[1]);
+    BulletPool* pools[2] = {&w.bullets, &w.playerBullets};
+    for (int p = 0; p < 2; ++p) {
+        BulletPool& dst = *pools[p];
+        const BulletPool& src = parsed[p];
+        std::size_t n = src.size();
+        dst.clear();
+        dst.grow(n);
+        for (auto column : {&BulletPool::x, &BulletPool::y, &BulletPool::vx, &BulletPool::vy, &BulletPool::startX, &BulletPool::startY,
+                            &BulletPool::radius, &BulletPool::scaleX, &BulletPool::scaleY, &BulletPool::lifeTime, &BulletPool::aliveTime}) {
+            std::copy_n((src.*column).begin(), n, (dst.*column).begin());
+        }
+        std::copy_n(src.color.begin(), n, dst.color.begin());
+        std::copy_n(src.flags.begin(), n, dst.flags.begin());
+    }
+    w.beams.clear();
+    for (const Beam& b : beams) w.beams.add(b);
+    return true;
+}
+
+// --- Delta Encoding ---
+// XORs a packed state against a base (the previous tick's, or nothing for
+// a keyframe) a 32-bit word at a time and run-length codes the result:
+//
+//   u32 size in bytes, then repeated { varint zero words, varint literal
+//   words, literal words }
+//
+// Between neighbouring ticks most columns are unchanged, so much of the
+// delta is zero runs that cost a byte or two each. Packed states are always
+// a whole number of words.
+namespace world_state {
+
+inline std::uint8_t* putVarint(std::uint8_t* p, std::size_t v) {
+    while (v >= 0x80) { *p++ = static_cast<std::uint8_t>(v | 0x80); v >>= 7; }
+    *p++ = static_cast<std::uint8_t>(v);
+    return p;
+}
+
+inline bool getVarint(const std::uint8_t*& p, const std::uint8_t* end, std::size_t& v) {
+    v = 0;
+    for (int shift = 0; p < end && shift < 64; shift += 7) {
+        std::uint8_t b = *p++;
+        v |= static_cast<std::size_t>(b & 0x7F) << shift;
+        if (!(b & 0x80)) return true;
+    }
+    return false;
+}
+
+inline std::uint32_t loadWord(const std::uint8_t* p) {
+    std::uint32_t v;
+    std::memcpy(&v, p, 4);
+    return v;
+}
+
+} // namespace world_state
+
+inline void encodeDelta(const std::vector<std::uint8_t>& base, const std::vector<std::uint8_t>& state, std::vector<std::uint8_t>& out) {
+    using namespace world_state;
+    const std::size_t words = state.size() / 4, shared = std::min(words, base.size() / 4);
+    // Every run but the last holds at least one literal and one zero word,
+    // so the two varints cost at most 5 bytes per word. The XORed words go
+    // in the tail of the buffer, which the output never overtakes.
+    const std::size_t tail = 4 + 10 + 5 * words;
+    out.resize(tail + 4 * words);
+    std::uint8_t* x = out.data() + tail;
+    for (std::size_t i = 0; i < shared; ++i) {
+        std::uint32_t v = loadWord(&state[i * 4]) ^ loadWord(&base[i * 4]);
+        std::memcpy(x + i * 4, &v, 4);
+    }
+    if (words > shared) std::memcpy(x + shared * 4, &state[shared * 4], (words - shared) * 4);
+
+    std::uint32_t size32 = static_cast<std::uint32_t>(state.size());
+    std::memcpy(out.data(), &size32, 4);
+    std::uint8_t* p = out.data() + 4;
+    std::size_t i = 0;
+    while (i < words) {
+        std::size_t zeros = i;
+        for (std::uint64_t pair; zeros + 2 <= words && (std::memcpy(&pair, x + zeros * 4, 8), pair == 0); ) zeros += 2;
+        while (zeros < words && loadWord(x + zeros * 4) == 0) ++zeros;
+        std::size_t literals = zeros;
+        while (literals < words && loadWord(x + literals * 4) != 0) ++literals;
+        p = putVarint(p, zeros - i);
+        p = putVarint(p, literals - zeros);
+        std::memmove(p, x + zeros * 4, (literals - zeros) * 4);
+        p += (literals - zeros) * 4;
+        i = literals;
+    }
+    out.resize(static_cast<std::size_t>(p - out.data()));
+}
+
+// Rebuilds a packed state from the base it was encoded against.
+inline bool decodeDelta(const std::vector<std::uint8_t>& base, const std::uint8_t* delta, std::size_t size, std::vector<std::uint8_t>& out) {
+    using namespace world_state;
+    if (size < 4) return false;
+    std::uint32_t n = loadWord(delta);
+    if (n > kMaxWorldStateBytes || n % 4 != 0) return false;
+    std::size_t shared = std::min<std::size_t>(n, base.size());
+    out.resize(n);
+    std::copy_n(base.begin(), shared, out.begin());
+    std::fill(out.begin() + static_cast<std::ptrdiff_t>(shared), out.end(), std::uint8_t(0));
+    const std::uint8_t* p = delta + 4;
+    const std::uint8_t* end = delta + size;
+    std::size_t i = 0, words = n / 4;
+    while (p < end) {
+        std::size_t zeros, literals;
+        if (!getVarint(p, end, zeros) || !getVarint(p, end, literals)) return false;
+        if (zeros > words - i || literals > words - i - zeros || static_cast<std::size_t>(end - p) / 4 < literals) return false;
+        for (i += zeros; literals > 0; --literals, ++i, p += 4) {
+            std::uint32_t v = loadWord(&out[i * 4]) ^ loadWord(p);
+            std::memcpy(&out[i * 4], &v, 4);
+        }
+    }
+    return true;
+}
+
+// --- Rewind Buffer ---
+// Keeps the last `capacity` ticks of state, captured once per tick. Every
+// keyframeInterval-th capture is coded against nothing, the rest against
+// the tick before, so going back decodes at most one keyframe's worth of
+// deltas. Entry buffers are reused as the ring wraps; a slot reallocates
+// only to grow, or to hand back a keyframe's worth of memory once it holds
+// a small delta again.
+class RewindBuffer {
+public:
+    explicit RewindBuffer(std::size_t capacity, std::size_t keyframeInterval = 60)
+        : entries(std::max<std::size_t>(capacity, 1)), keyframeInterval(std::max<std::size_t>(keyframeInterval, 1)) {}
+
+    std::size_t size() const { return count; }
+    std::size_t capacity() const { return entries.size(); }
+    void clear() { count = 0; sinceKeyframe = 0; previous.clear(); }
+
+    std::size_t bytesUsed() const {
+        std::size_t total = 0;
+        for (std::size_t k = 0; k < count; ++k) total += at(k).data.size();
+        return total;
+    }
+
+    // Call after each tick.
+    bool capture(const World& world, std::string* error = nullptr) {
+        if (!serializeWorld(world, current, error)) return false;
+        Entry& e = entries[(first + count) % entries.size()];
+        if (count == entries.size()) first = (first + 1) % entries.size();
+        else ++count;
+        e.keyframe = sinceKeyframe == 0 || previous.empty();
+        encodeDelta(e.keyframe ? empty : previous, current, encoded);
+        if (e.data.capacity() > 2 * encoded.size() + 4096) std::vector<std::uint8_t>().swap(e.data);
+        e.data.assign(encoded.begin(), encoded.end());
+        sinceKeyframe = (sinceKeyframe + 1) % keyframeInterval;
+        previous.swap(current);
+        return true;
+    }
+
+    // Captures from the oldest keyframe still held to the newest. Once the
+    // ring wraps, the deltas in front of that keyframe cannot be rebuilt, so
+    // rewind() takes ticksBack up to one less than this.
+    std::size_t reachable() const {
+        std::size_t key = 0;
+        while (key < count && !at(key).keyframe) ++key;
+        return count - key;
+    }
+
+    // Puts `world` back `ticksBack` captures before the newest (0 is the
+    // newest) and forgets everything after it, so capturing carries on from
+    // there. Fails if that is before the oldest keyframe still held.
+    bool rewind(std::size_t ticksBack, World& world, std::string* error = nullptr) {
+        if (ticksBack >= count) {
+            if (error) *error = "not that many ticks recorded";
+            return false;
+        }
+        std::size_t target = count - 1 - ticksBack, key = target;
+        while (!at(key).keyframe) {
+            if (key == 0) {
+                if (error) *error = "rewound past the oldest keyframe";
+                return false;
+            }
+            --key;
+        }
+        if (!decodeAt(key, empty, previous)) return corrupt(error);
+        for (std::size_t k = key + 1; k <= target; ++k) {
+            if (!decodeAt(k, previous, current)) return corrupt(error);
+            previous.swap(current);
+        }
+        if (!deserializeWorld(previous.data(), previous.size(), world, error)) return false;
+        count = target + 1;
+        sinceKeyframe = (target - key + 1) % keyframeInterval;
+        return true;
+    }
+
+private:
+    struct Entry {
+        std::vector<std::uint8_t> data;
+        bool keyframe = false;
+    };
+
+    const Entry& at(std::size_t k) const { return entries[(first + k) % entries.size()]; }
+    bool decodeAt(std::size_t k, const std::vector<std::uint8_t>& base, std::vector<std::uint8_t>& out) const {
+        return decodeDelta(base, at(k).data.data(), at(k).data.size(), out);
+    }
+    static bool corrupt(std::string* error) {
+        if (error) *error = "corrupt rewind entry";
+        return false;
+    }
+
+    std::vector<Entry> entries;
+    std::size_t first = 0, count = 0;
+    std::size_t keyframeInterval, sinceKeyframe = 0;
+    std::vector<std::uint8_t> previous, current, encoded;
+    const std::vector<std::uint8_t> empty;
+};
+
+// --- Save States ---
+// A save state on disk is a single keyframe, for practice runs that start
+// anywhere in a fight.
+inline bool saveWorldState(const std::string& path, const World& world, std::string* error = nullptr) {
+    std::vector<std::uint8_t> state, packed;
+    if (!serializeWorld(world, state, error)) return false;
+    encodeDelta({}, state, packed);
+    std::FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        if (error) *error = "cannot write " + path;
+        return false;
+    }
+    bool ok = std::fwrite(packed.data(), 1, packed.size(), f) == packed.size();
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok && error) *error = "failed writing " + path;
+    return ok;
+}
+
+// Reads a save state file back to packed form, for deserializeWorld().
+inline bool readWorldState(const std::string& path, std::vector<std::uint8_t>& state, std::string* error = nullptr) {
+    std::FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        if (error) *error = "cannot open " + path;
+        return false;
+    }
+    std::vector<std::uint8_t> packed;
+    std::uint8_t buffer[1 << 16];
+    for (std::size_t n; (n = std::fread(buffer, 1, sizeof buffer, f)) > 0; ) packed.insert(packed.end(), buffer, buffer + n);
+    std::fclose(f);
+    if (!decodeDelta({}, packed.data(), packed.size(), state)) {
+        if (error) *error = path + " is not a save state";
+        return false;
+    }
+    return true;
+}
+
+inline bool loadWorldState(const std::string& path, World& world, std::string* error = nullptr) {
+    std::vector<std::uint8_t> state;
+    if (!readWorldState(path, state, error)) return false;
+    if (!deserializeWorld(state.data(), state.size(), world, error)) {
+        if (error) *error = path + ": " + *error;
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,221 @@
+// Balance runner: plays many independent fights with a bot at the controls,
+// one fight per job across every core, and reports how they went as JSON
+// on stdout.
+//
+//   batch [--fights N] [--seed N] [--bot NAME] [--threads N] [--tick-rate HZ] [--density N]
+//         [--patterns FILE] [--max-seconds S] [--csv FILE]
+//
+// Fight i plays seed + i, so a batch is reproducible whatever the thread
+// count, and any fight can be rerun alone with headless --seed --bot.
+// A fight ends in a win, a loss, or a timeout after --max-seconds of
+// simulated time (600 by default).
+//
+// The report gives the win rate, time to kill over the wins, and per phase
+// (the six attacks and three survivals, each counting its warning) the
+// time spent, damage taken, peak enemy bullets and simulation cost per tick.
+// sim_speed_per_core is simulated seconds per second of one core's time.
+// --csv also writes one row per fight.
+#include "Bot.hpp"
+#include "World.hpp"
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using Clock = std::chrono::steady_clock;
+
+constexpr int kPhaseCount = 9;
+
+static const char* phaseName(int phase) {
+    return phase < 6 ? World::attackPatternNames[phase] : World::survivalPatternNames[phase - 6];
+}
+
+// The phase a tick belongs to; warnings count towards the phase they lead
+// into.
+static int phaseOf(const World& world) {
+    if (world.isSurvival) return 6 + std::clamp(world.nextThreshold - 2, 0, 2);
+    if (world.isSurvivalWarning) return 6 + std::clamp(world.nextThreshold - 1, 0, 2);
+    return std::clamp(world.currentPhase - 1, 0, 5);
+}
+
+enum class Outcome { Win, Loss, Timeout };
+
+static const char* outcomeName(Outcome o) {
+    return o == Outcome::Win ? "win" : o == Outcome::Loss ? "loss" : "timeout";
+}
+
+struct PhaseStats {
+    long ticks = 0;
+    float damage = 0.f;
+    std::size_t peakBullets = 0;
+    double ns = 0, maxNs = 0;
+};
+
+struct FightResult {
+    std::uint64_t seed = 0;
+    Outcome outcome = Outcome::Timeout;
+    long ticks = 0;
+    float bossHP = 0.f, playerHP = 0.f;
+    double wallSeconds = 0;
+    std::array<PhaseStats, kPhaseCount> phases;
+};
+
+struct BatchConfig {
+    std::uint64_t seed = 1;
+    std::string bot = "dodge";
+    float tickRate = 120.f;
+    int density = 1;
+    float maxSeconds = 600.f;
+    PatternLibrary patterns;
+};
+
+static FightResult fight(const BatchConfig& cfg, std::uint64_t seed) {
+    World world(seed, BulletPool::kDefaultCapacity * cfg.density, cfg.tickRate);
+    world.setPatterns(cfg.patterns, cfg.density);
+    std::unique_ptr<BotPolicy> bot = makeBot(cfg.bot);
+
+    FightResult r;
+    r.seed = seed;
+    long maxTicks = world.ticks(cfg.maxSeconds);
+    auto start = Clock::now();
+    for (long t = 0; t < maxTicks && !world.isOver(); ++t) {
+        InputFrame input = bot->next(world, t);
+        PhaseStats& phase = r.phases[phaseOf(world)];
+        float health = world.playerHealth;
+        auto t0 = Clock::now();
+        world.step(input);
+        double ns = std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+        ++phase.ticks;
+        phase.damage += health - world.playerHealth;
+        phase.peakBullets = std::max(phase.peakBullets, world.bullets.size());
+        phase.ns += ns;
+        phase.maxNs = std::max(phase.maxNs, ns);
+        ++r.ticks;
+    }
+    r.wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+    r.outcome = world.isVictory ? Outcome::Win : world.isGameOver ? Outcome::Loss : Outcome::Timeout;
+    r.bossHP = world.bossCurrentHP;
+    r.playerHP = world.playerHealth;
+    return r;
+}
+
+static double percentile(std::vector<double> v, double p) {
+    if (v.empty()) return 0.0;
+    std::sort(v.begin(), v.end());
+    return v[static_cast<std::size_t>(p * (v.size() - 1) + 0.5)];
+}
+
+static bool writeCsv(const std::string& path, const std::vector<FightResult>& results, float tickRate) {
+    std::FILE* f = std::fopen(path.c_str(), "w");
+    if (!f) return false;
+    std::fprintf(f, "seed,outcome,seconds,boss_hp,player_hp");
+    for (int p = 0; p < kPhaseCount; ++p) std::fprintf(f, ",%s_seconds,%s_damage", phaseName(p), phaseName(p));
+    std::fprintf(f, "\n");
+    for (const FightResult& r : results) {
+        std::fprintf(f, "%llu,%s,%.3f,%.1f,%.1f", static_cast<unsigned long long>(r.seed), outcomeName(r.outcome), r.ticks / tickRate, r.bossHP, r.playerHP);
+        for (const PhaseStats& s : r.phases) std::fprintf(f, ",%.3f,%.1f", s.ticks / tickRate, s.damage);
+        std::fprintf(f, "\n");
+    }
+    return std::fclose(f) == 0;
+}
+
+int main(int argc, char** argv) {
+    BatchConfig cfg;
+    long fights = 1000;
+    unsigned threads = 0;
+    std::string csvPath;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--fights" && i + 1 < argc) fights = std::max(1l, std::strtol(argv[++i], nullptr, 10));
+        else if (arg == "--seed" && i + 1 < argc) cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--bot" && i + 1 < argc) cfg.bot = argv[++i];
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--tick-rate" && i + 1 < argc) cfg.tickRate = std::max(10.f, std::strtof(argv[++i], nullptr));
+        else if (arg == "--density" && i + 1 < argc) cfg.density = std::max(1, static_cast<int>(std::strtol(argv[++i], nullptr, 10)));
+        else if (arg == "--max-seconds" && i + 1 < argc) cfg.maxSeconds = std::strtof(argv[++i], nullptr);
+        else if (arg == "--csv" && i + 1 < argc) csvPath = argv[++i];
+        else if (arg == "--patterns" && i + 1 < argc) {
+            std::string error;
+            if (!cfg.patterns.loadFile(argv[++i], &error)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 2;
+            }
+        } else {
+            std::fprintf(stderr, "usage: %s [--fights N] [--seed N] [--bot NAME] [--threads N] [--tick-rate HZ] [--density N]\n"
+                                 "       [--patterns FILE] [--max-seconds S] [--csv FILE]\n", argv[0]);
+            return 2;
+        }
+    }
+    if (!makeBot(cfg.bot)) {
+        std::string names;
+        for (const char* name : kBotNames) names += std::string(names.empty() ? "" : ", ") + name;
+        std::fprintf(stderr, "unknown bot %s (have %s)\n", cfg.bot.c_str(), names.c_str());
+        return 2;
+    }
+
+    // Each fight writes only its own slot, so results do not depend on
+    // which worker ran what.
+    JobSystem jobs(threads);
+    std::vector<FightResult> results(static_cast<std::size_t>(fights));
+    auto start = Clock::now();
+    jobs.parallelFor(results.size(), 1, [&](std::size_t begin, std::size_t end, unsigned) {
+        for (std::size_t i = begin; i < end; ++i) results[i] = fight(cfg, cfg.seed + i);
+    });
+    double wallSeconds = std::chrono::duration<double>(Clock::now() - start).count();
+
+    long wins = 0, losses = 0, timeouts = 0, ticks = 0;
+    double cpuSeconds = 0;
+    std::vector<double> killTimes;
+    std::array<PhaseStats, kPhaseCount> phases;
+    std::array<long, kPhaseCount> phaseFights{};
+    for (const FightResult& r : results) {
+        wins += r.outcome == Outcome::Win;
+        losses += r.outcome == Outcome::Loss;
+        timeouts += r.outcome == Outcome::Timeout;
+        if (r.outcome == Outcome::Win) killTimes.push_back(r.ticks / cfg.tickRate);
+        ticks += r.ticks;
+        cpuSeconds += r.wallSeconds;
+        for (int p = 0; p < kPhaseCount; ++p) {
+            const PhaseStats& s = r.phases[p];
+            if (s.ticks == 0) continue;
+            ++phaseFights[p];
+            phases[p].ticks += s.ticks;
+            phases[p].damage += s.damage;
+            phases[p].peakBullets = std::max(phases[p].peakBullets, s.peakBullets);
+            phases[p].ns += s.ns;
+            phases[p].maxNs = std::max(phases[p].maxNs, s.maxNs);
+        }
+    }
+    double simSeconds = ticks / cfg.tickRate;
+    double meanKill = 0;
+    for (double t : killTimes) meanKill += t / killTimes.size();
+
+    std::printf("{\"fights\": %ld, \"seed\": %llu, \"bot\": \"%s\", \"tick_rate\": %.0f, \"density\": %d, \"threads\": %u,\n"
+                " \"wins\": %ld, \"losses\": %ld, \"timeouts\": %ld, \"win_rate\": %.4f,\n"
+                " \"time_to_kill_s\": {\"mean\": %.2f, \"p10\": %.2f, \"p50\": %.2f, \"p90\": %.2f},\n"
+                " \"sim_seconds\": %.1f, \"wall_seconds\": %.3f, \"sim_speed\": %.1f, \"sim_speed_per_core\": %.1f,\n"
+                " \"phases\": [\n",
+                fights, static_cast<unsigned long long>(cfg.seed), cfg.bot.c_str(), cfg.tickRate, cfg.density, jobs.workerCount(),
+                wins, losses, timeouts, double(wins) / fights,
+                meanKill, percentile(killTimes, 0.1), percentile(killTimes, 0.5), percentile(killTimes, 0.9),
+                simSeconds, wallSeconds, wallSeconds > 0 ? simSeconds / wallSeconds : 0.0, cpuSeconds > 0 ? simSeconds / cpuSeconds : 0.0);
+    for (int p = 0; p < kPhaseCount; ++p) {
+        const PhaseStats& s = phases[p];
+        double seconds = s.ticks / cfg.tickRate;
+        std::printf("    {\"name\": \"%s\", \"fights\": %ld, \"seconds_per_fight\": %.2f, \"damage_per_fight\": %.1f, \"damage_per_minute\": %.1f, "
+                    "\"peak_bullets\": %zu, \"ns_per_tick\": %.1f, \"max_ns_per_tick\": %.1f}%s\n",
+                    phaseName(p), phaseFights[p], phaseFights[p] ? seconds / phaseFights[p] : 0.0, phaseFights[p] ? s.damage / phaseFights[p] : 0.0,
+                    seconds > 0 ? s.damage / seconds * 60.0 : 0.0, s.peakBullets, s.ticks ? s.ns / s.ticks : 0.0, s.maxNs,
+                    p + 1 < kPhaseCount ? "," : "");
+    }
+    std::printf(" ]}\n");
+
+    if (!csvPath.empty() && !writeCsv(csvPath, results, cfg.tickRate)) {
+        std::fprintf(stderr, "cannot write %s\n", csvPath.c_str());
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,248 @@
+// Stress benchmark: holds each attack phase and survival pattern for a fixed
+// number of ticks and reports per-stage timings as JSON on stdout.
+//
+//   bench [--ticks N] [--warmup N] [--tick-rate HZ] [--density 1,10,100] [--scenario NAME]
+//         [--kernel scalar|sse2|avx2] [--threads N] [--rewind] [--shed]
+//   bench --directions [--ticks N]
+//
+// Stages: spawn = pattern emission, integrate = bullet movement plus the
+// kernel's swept hit test against the player, cleanup = expiry/detonation/
+// culling, collide = beams, the player shots' broadphase + narrowphase
+// against the boss, and landing both sides' hits in time order, other =
+// timers, boss and player. --ticks is at least 1.
+//
+// Every scenario also times the render side per tick, outside ns_per_tick:
+// copying the World into a RenderSnapshot and building its BulletBatch, with
+// the quads built.
+//
+// --rewind also captures every tick into a ten second RewindBuffer and adds
+// its cost as a capture stage (not part of ns_per_tick), with the packed
+// state size and the delta bytes kept per tick.
+//
+// --shed runs with the frame governor's simulation load shedding on:
+// off-screen bullets and shards that cannot return are dropped early.
+//
+// --directions instead times ring emission with a sin/cos per bullet against
+// the compile-time direction tables turned once per volley, per ring shape.
+#define ALLOCATION_COUNTER_IMPLEMENTATION
+#include "AllocationCounter.hpp"
+#include "RenderSnapshot.hpp"
+#include "World.hpp"
+#include "WorldState.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+struct Scenario {
+    const char* name;
+    int phase;    // 1-6, or 0 for a survival pattern
+    int survival; // 1-3
+};
+
+static const Scenario scenarios[] = {
+    {"spiral", 1, 0}, {"rain", 2, 0}, {"gaps", 3, 0}, {"cross", 4, 0}, {"shotgun", 5, 0}, {"stream", 6, 0},
+    {"knife_wall", 0, 1}, {"dense_cross", 0, 2}, {"miasma_towers", 0, 3},
+};
+
+using Clock = std::chrono::steady_clock;
+
+static double nsSince(Clock::time_point t0) {
+    return std::chrono::duration<double, std::nano>(Clock::now() - t0).count();
+}
+
+static void runScenario(const Scenario& sc, int density, long ticks, long warmup, float tickRate, KernelIsa isa, JobSystem& jobs, bool rewind, bool shed, bool first) {
+    World world(1, BulletPool::kDefaultCapacity * density, tickRate);
+    world.setJobs(&jobs);
+    world.setPatterns(PatternLibrary(), density);
+    world.kernelIsa = isa;
+    world.shedOffscreen = world.shedShards = shed;
+    if (sc.phase) world.forcePattern(sc.phase);
+    else world.forceSurvival(sc.survival);
+    world.lockPattern = true;
+    world.invulnerable = true;
+
+    double other = 0, spawn = 0, integrate = 0, cleanup = 0, collide = 0, capture = 0, snapshotNs = 0, batchNs = 0;
+    std::size_t peak = 0, bulletTicks = 0, allocs = 0, stateBytes = 0, quads = 0;
+    RenderSnapshot snapshot;
+    snapshot.reserve(world);
+    BulletBatch batch;
+    batch.vertices.reserve((world.bullets.capacity() + world.playerBullets.capacity() + world.beams.capacity()) * 6);
+    RewindBuffer history(rewind ? static_cast<std::size_t>(world.ticks(10.f)) : 1);
+    std::vector<std::uint8_t> state;
+    for (long t = -warmup; t < ticks; ++t) {
+        InputFrame input;
+        input.fire = true;
+        input.aim = world.bossPos;
+
+        std::size_t allocsBefore = allocationCount();
+        auto t0 = Clock::now();
+        world.beginTick(input);
+        double tOther = nsSince(t0);
+        t0 = Clock::now();
+        world.spawnBullets();
+        double tSpawn = nsSince(t0);
+        t0 = Clock::now();
+        world.integrateBullets();
+        double tIntegrate = nsSince(t0);
+        t0 = Clock::now();
+        world.cullBullets();
+        double tCleanup = nsSince(t0);
+        t0 = Clock::now();
+        world.resolveCollisions();
+        world.endTick();
+        double tCollide = nsSince(t0);
+        std::size_t tickAllocs = allocationCount() - allocsBefore;
+
+        t0 = Clock::now();
+        snapshot.capture(world, 0);
+        double tSnapshot = nsSince(t0);
+        t0 = Clock::now();
+        batch.clear();
+        batch.addSprites(snapshot.bullets, 0.5f);
+        batch.addBeams(snapshot.beams, 0.5f);
+        double tBatch = nsSince(t0);
+
+        double tCapture = 0;
+        if (rewind) {
+            t0 = Clock::now();
+            history.capture(world);
+            tCapture = nsSince(t0);
+        }
+
+        if (t < 0) continue;
+        other += tOther; spawn += tSpawn; integrate += tIntegrate; cleanup += tCleanup; collide += tCollide;
+        allocs += tickAllocs;
+        capture += tCapture;
+        snapshotNs += tSnapshot; batchNs += tBatch;
+        quads += batch.quadCount();
+        peak = std::max(peak, world.bullets.size());
+        bulletTicks += world.bullets.size();
+    }
+
+    double total = other + spawn + integrate + cleanup + collide;
+    std::printf("%s    {\"name\": \"%s\", \"density\": %d, \"kernel\": \"%s\", \"threads\": %u, \"ticks\": %ld, \"ns_per_tick\": %.1f, \"ns_per_bullet\": %.2f, "
+                "\"peak_bullets\": %zu, \"allocs_per_tick\": %.3f, \"stages_ns_per_tick\": {\"other\": %.1f, \"spawn\": %.1f, "
+                "\"integrate\": %.1f, \"cleanup\": %.1f, \"collide\": %.1f}, "
+                "\"render\": {\"snapshot_ns_per_tick\": %.1f, \"batch_ns_per_tick\": %.1f, \"quads_per_tick\": %.1f}",
+                first ? "" : ",\n", sc.name, density, kernelIsaName(isa), jobs.workerCount(), ticks, total / ticks, bulletTicks ? total / bulletTicks : 0.0,
+                peak, double(allocs) / ticks, other / ticks, spawn / ticks, integrate / ticks, cleanup / ticks, collide / ticks,
+                snapshotNs / ticks, batchNs / ticks, double(quads) / ticks);
+    if (rewind) {
+        serializeWorld(world, state);
+        stateBytes = state.size();
+        std::printf(", \"rewind\": {\"capture_ns_per_tick\": %.1f, \"state_bytes\": %zu, \"bytes_per_tick\": %.1f}}",
+                    capture / ticks, stateBytes, history.size() ? double(history.bytesUsed()) / history.size() : 0.0);
+    } else {
+        std::printf("}");
+    }
+}
+
+// Fills one ring's velocities per volley, both ways, and reports ns per
+// bullet for each and the largest component difference between them.
+static void runDirectionBench(int count, int step, long volleys, bool first) {
+    const float speed = 5.f, spin = 7.5f; // a non-whole spin takes the Rotation's trig path
+    std::vector<float> vx(count), vy(count), tx(count), ty(count);
+    volatile float sink = 0.f;
+
+    float rotation = 0.f;
+    auto t0 = Clock::now();
+    for (long v = 0; v < volleys; ++v) {
+        rotation = std::fmod(rotation + spin, 360.f);
+        for (int i = 0; i < count; ++i) {
+            float rad = (rotation + i * step) * (PI / 180.f);
+            vx[i] = std::cos(rad) * speed;
+            vy[i] = std::sin(rad) * speed;
+        }
+        sink = sink + vx[0];
+    }
+    double trig = nsSince(t0);
+
+    rotation = 0.f;
+    const Direction* ring = ringDirections(count, static_cast<float>(step));
+    t0 = Clock::now();
+    for (long v = 0; v < volleys; ++v) {
+        rotation = std::fmod(rotation + spin, 360.f);
+        Rotation rot(rotation);
+        for (int i = 0; i < count; ++i) {
+            Direction d = rot.apply(ring[i]);
+            tx[i] = d.x * speed;
+            ty[i] = d.y * speed;
+        }
+        sink = sink + tx[0];
+    }
+    double table = nsSince(t0);
+
+    float maxError = 0.f;
+    for (int i = 0; i < count; ++i) maxError = std::max({maxError, std::abs(vx[i] - tx[i]) / speed, std::abs(vy[i] - ty[i]) / speed});
+    double bullets = double(volleys) * count;
+    std::printf("%s    {\"ring\": \"%dx%d\", \"volleys\": %ld, \"trig_ns_per_bullet\": %.2f, \"table_ns_per_bullet\": %.2f, "
+                "\"speedup\": %.2f, \"max_error\": %.2e}",
+                first ? "" : ",\n", count, step, volleys, trig / bullets, table / bullets, table > 0 ? trig / table : 0.0, maxError);
+}
+
+int main(int argc, char** argv) {
+    long ticks = 2000, warmup = 600;
+    float tickRate = 120.f;
+    std::vector<int> densities{1};
+    std::string only;
+    KernelIsa isa = bestKernelIsa();
+    unsigned threads = 0;
+    bool directions = false, rewind = false, shed = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--ticks" && i + 1 < argc) ticks = std::max(1l, std::strtol(argv[++i], nullptr, 10));
+        else if (arg == "--warmup" && i + 1 < argc) warmup = std::max(0l, std::strtol(argv[++i], nullptr, 10));
+        else if (arg == "--tick-rate" && i + 1 < argc) tickRate = std::max(10.f, std::strtof(argv[++i], nullptr));
+        else if (arg == "--scenario" && i + 1 < argc) only = argv[++i];
+        else if (arg == "--directions") directions = true;
+        else if (arg == "--rewind") rewind = true;
+        else if (arg == "--shed") shed = true;
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--kernel" && i + 1 < argc) {
+            std::string name = argv[++i];
+            isa = name == "avx2" ? KernelIsa::AVX2 : name == "sse2" ? KernelIsa::SSE2 : KernelIsa::Scalar;
+            if (!kernelIsaSupported(isa) || name != kernelIsaName(isa)) {
+                std::fprintf(stderr, "kernel %s is not available on this machine\n", name.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--density" && i + 1 < argc) {
+            densities.clear();
+            for (char* p = argv[++i]; *p; ) {
+                densities.push_back(std::max(1, static_cast<int>(std::strtol(p, &p, 10))));
+                if (*p == ',') ++p;
+                else break;
+            }
+        } else {
+            std::fprintf(stderr, "usage: %s [--ticks N] [--warmup N] [--tick-rate HZ] [--density 1,10,100] [--scenario NAME] [--kernel scalar|sse2|avx2] [--threads N] [--rewind] [--shed]\n"
+                                 "       %s --directions [--ticks N]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+
+    if (directions) {
+        const std::pair<int, int> rings[] = {{12, 30}, {36, 10}, {6, 60}, {4, 90}};
+        std::printf("{\"directions\": [\n");
+        for (std::size_t k = 0; k < std::size(rings); ++k) runDirectionBench(rings[k].first, rings[k].second, ticks * 500, k == 0);
+        std::printf("\n]}\n");
+        return 0;
+    }
+
+    JobSystem jobs(threads);
+    std::printf("{\"scenarios\": [\n");
+    bool first = true;
+    for (int density : densities) {
+        for (const Scenario& sc : scenarios) {
+            if (!only.empty() && only != sc.name) continue;
+            runScenario(sc, density, ticks, warmup, tickRate, isa, jobs, rewind, shed, first);
+            first = false;
+        }
+    }
+    std::printf("\n]}\n");
+    return 0;
+}
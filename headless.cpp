@@ -0,0 +1,496 @@
+// Runs the fight without a window: N ticks of a bot's input (the circle bot
+// unless --bot names another, see Bot.hpp), then prints a summary and a
+// hash of the final state.
+//
+//   headless [--seed N] [--ticks N] [--tick-rate HZ] [--threads N] [--density N] [--patterns FILE]
+//            [--record FILE] [--trace FILE] [--load FILE] [--save FILE] [--bot NAME] [--check]
+//   headless --replay FILE... [--min-speed X] [--threads N] [--patterns FILE]
+//
+// --patterns overrides built-in attack patterns with those defined in FILE.
+// --threads sets the job system's thread count (0, the default, uses every
+// hardware thread); --density multiplies every pattern's bullets.
+//
+// --check runs the same seed twice and fails if the two runs diverge, then
+// checks every bullet kernel this CPU supports against the scalar one and
+// reruns with other thread counts. It also fails if any tick after the first
+// second allocates, if the direction tables stray from trig, if a bullet
+// can tunnel through the player or the boss in one tick, if the final
+// state does not survive a save and load, or a rewind and rerun, unchanged,
+// or if load shedding changes anything the player could notice.
+//
+// --record saves the run as a replay. --replay reruns each replay file as
+// fast as possible, printing one JSON line per file, and fails if any final
+// state differs from the recorded one or, with --min-speed, if any runs
+// slower than X times real time.
+//
+// --load starts the run from a save state instead of the fight's opening;
+// --save writes the final state as one.
+//
+// --trace writes a Chrome trace of the run, one frame per tick; it needs a
+// profiler build (make PROFILE=1).
+#define ALLOCATION_COUNTER_IMPLEMENTATION
+#include "AllocationCounter.hpp"
+#include "Bot.hpp"
+#include "Replay.hpp"
+#include "World.hpp"
+#include "WorldState.hpp"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iterator>
+#include <string>
+#include <tuple>
+#include <utility>
+#include <vector>
+
+struct RunConfig {
+    std::uint64_t seed = 1;
+    long ticks = -1;
+    float tickRate = 120.f;
+    int density = 1;
+    PatternLibrary patterns;
+    JobSystem* jobs = nullptr;
+    KernelIsa isa = bestKernelIsa();
+    std::vector<std::uint8_t> startState; // packed world state to start from, if any
+    std::string bot = "circle";
+    bool shed = false; // the frame governor's simulation-side load shedding
+};
+
+static World makeWorld(const RunConfig& cfg) {
+    World world(cfg.seed, BulletPool::kDefaultCapacity * cfg.density, cfg.tickRate);
+    world.setPatterns(cfg.patterns, cfg.density);
+    world.kernelIsa = cfg.isa;
+    world.setJobs(cfg.jobs);
+    world.shedOffscreen = world.shedShards = cfg.shed;
+    if (!cfg.startState.empty()) deserializeWorld(cfg.startState.data(), cfg.startState.size(), world); // validated by main()
+    return world;
+}
+
+// Plays cfg.ticks ticks of the bot's input. steadyAllocs receives the heap
+// allocations made after the first second; recorder, if open, gets every
+// tick's input.
+static World run(const RunConfig& cfg, std::size_t* steadyAllocs = nullptr, ReplayRecorder* recorder = nullptr) {
+    World world = makeWorld(cfg);
+    std::unique_ptr<BotPolicy> bot = makeBot(cfg.bot);
+    long warmup = world.ticks(1.f);
+    std::size_t allocs = 0;
+    for (long t = 0; t < cfg.ticks; ++t) {
+        InputFrame input = bot->next(world, t);
+        std::size_t before = allocationCount();
+        if (recorder) recorder->record(input);
+        world.step(input);
+#ifdef ENABLE_PROFILER
+        Profiler::instance().endFrame();
+#endif
+        if (t >= warmup) allocs += allocationCount() - before;
+    }
+    if (steadyAllocs) *steadyAllocs = allocs;
+    return world;
+}
+
+// Reruns a recorded fight with no window, as fast as the CPU allows. Fails
+// when the final state differs from the one recorded or when playback runs
+// slower than minSpeed times real time.
+static bool playReplay(const std::string& path, const RunConfig& cfg, double minSpeed) {
+    ReplayReader reader;
+    std::string error;
+    if (!reader.open(path, cfg.patterns, &error)) {
+        std::fprintf(stderr, "%s\n", error.c_str());
+        return false;
+    }
+    const ReplayHeader& info = reader.info();
+    World world(info.seed, BulletPool::kDefaultCapacity * info.density, info.tickRate);
+    world.setPatterns(cfg.patterns, info.density);
+    world.kernelIsa = cfg.isa;
+    world.setJobs(cfg.jobs);
+
+    auto t0 = std::chrono::steady_clock::now();
+    std::uint64_t ticks = 0;
+    for (InputFrame input; reader.next(input); ++ticks) world.step(input);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    double speed = seconds > 0 ? ticks / info.tickRate / seconds : 0.0;
+    std::uint64_t hash = world.stateHash();
+
+    bool matches = ticks == info.ticks && (info.finalHash == 0 || hash == info.finalHash);
+    bool ok = matches && (minSpeed <= 0 || speed >= minSpeed);
+    std::printf("{\"replay\": \"%s\", \"ticks\": %llu, \"hash\": \"%016llx\", \"expected_hash\": \"%016llx\", "
+                "\"matches\": %s, \"seconds\": %.4f, \"speed\": %.1f, \"ok\": %s}\n",
+                path.c_str(), static_cast<unsigned long long>(ticks), static_cast<unsigned long long>(hash),
+                static_cast<unsigned long long>(info.finalHash), matches ? "true" : "false", seconds, speed, ok ? "true" : "false");
+    return ok;
+}
+
+// Random pools of awkward sizes, straddling every kernel boundary: each ISA
+// must leave the pool and the masks bit-identical to the scalar path.
+static bool kernelMatchesScalar(KernelIsa isa) {
+    Rng rng(42);
+    auto uniform = [&](float lo, float hi) { return lo + (hi - lo) * (rng.next() / 4294967296.f); };
+    for (std::size_t n : {0u, 1u, 7u, 8u, 9u, 15u, 64u, 1003u}) {
+        BulletPool pool(n);
+        for (std::size_t i = 0; i < n; ++i) {
+            sf::Vector2f pos{uniform(-200.f, 2120.f), uniform(-200.f, 1280.f)};
+            sf::Vector2f start = rng.below(2) ? pos : sf::Vector2f{uniform(0.f, 1920.f), uniform(0.f, 1080.f)};
+            if (rng.below(4) == 0) pos = sf::Vector2f{960.f, 540.f} + sf::Vector2f{uniform(-30.f, 30.f), uniform(-30.f, 30.f)};
+            int j = pool.spawnWithVelocity(start, {uniform(-8.f, 8.f), uniform(-8.f, 8.f)}, uniform(3.f, 12.f), sf::Color::Red,
+                                           static_cast<std::uint8_t>(rng.below(8)), rng.below(3) ? -1.f : static_cast<float>(rng.below(40)));
+            pool.x[j] = pos.x;
+            pool.y[j] = pos.y;
+            pool.scaleX[j] = uniform(0.5f, 2.f);
+            pool.aliveTime[j] = static_cast<float>(rng.below(40));
+        }
+        KernelParams params{-150.f, -150.f, 2070.f, 1230.f, 400.f * 400.f, 850.f * 850.f, 960.f, 540.f, 15.f,
+                            uniform(-20.f, 20.f), uniform(-20.f, 20.f)};
+        if (n % 2) { // odd sizes also shed off-screen bullets
+            params.shedMinX = params.shedMinY = 0.f;
+            params.shedMaxX = 1920.f;
+            params.shedMaxY = 1080.f;
+        }
+        BulletPool expected = pool;
+        BulletMasks expectedMasks, masks;
+        runBulletKernel(KernelIsa::Scalar, expected, params, expectedMasks);
+        runBulletKernel(isa, pool, params, masks);
+
+        // Empty vectors may hand out null data(), which memcmp must not see.
+        std::size_t blocks = masks.blocks;
+        if (n == 0) continue;
+        auto same = [n](const std::vector<float>& a, const std::vector<float>& b) { return std::memcmp(a.data(), b.data(), n * sizeof(float)) == 0; };
+        auto sameMask = [blocks](const std::vector<std::uint8_t>& a, const std::vector<std::uint8_t>& b) { return std::memcmp(a.data(), b.data(), blocks) == 0; };
+        if (!same(pool.x, expected.x) || !same(pool.y, expected.y) || !same(pool.aliveTime, expected.aliveTime) ||
+            !sameMask(masks.alive, expectedMasks.alive) || !sameMask(masks.expired, expectedMasks.expired) ||
+            !sameMask(masks.exploded, expectedMasks.exploded) || !sameMask(masks.hit, expectedMasks.hit)) {
+            std::fprintf(stderr, "kernel check failed: %s differs from scalar with %zu bullets\n", kernelIsaName(isa), n);
+            return false;
+        }
+    }
+    return true;
+}
+
+// The emitters' table-and-rotation directions against the trig they
+// replace: every whole degree, each specialised ring under assorted volley
+// rotations, and density cones built by repeated rotation.
+static bool directionsMatchTrig() {
+    auto near = [](Direction d, float degrees) {
+        float rad = degrees * (PI / 180.f);
+        return std::abs(d.x - std::cos(rad)) <= kDirectionTolerance && std::abs(d.y - std::sin(rad)) <= kDirectionTolerance;
+    };
+    for (int deg = -720; deg <= 720; ++deg) {
+        if (!near(unitDirection(static_cast<float>(deg)), static_cast<float>(deg))) {
+            std::fprintf(stderr, "direction check failed: table entry for %d degrees\n", deg);
+            return false;
+        }
+    }
+    const std::pair<int, int> rings[] = {{12, 30}, {36, 10}, {6, 60}, {4, 90}};
+    for (auto [count, step] : rings) {
+        const Direction* ring = ringDirections(count, static_cast<float>(step));
+        for (float base : {0.f, 2.f, 17.5f, 123.4f, -95.25f, 721.f}) {
+            Rotation rot(base);
+            for (int i = 0; i < count; ++i) {
+                if (!ring || !near(rot.apply(ring[i]), base + i * step)) {
+                    std::fprintf(stderr, "direction check failed: ring %dx%d at %.2f degrees\n", count, step, base);
+                    return false;
+                }
+            }
+        }
+    }
+    if (ringDirections(13, -970.f) || ringDirections(11, 1030.f) || ringDirections(12, 30.5f)) {
+        std::fprintf(stderr, "direction check failed: a ring without a table got one\n");
+        return false;
+    }
+    for (int density : {1, 3, 10, 100}) {
+        Rotation cone(10.f / density);
+        Direction d = unitDirection(33.f);
+        for (int rep = 0; rep < density; ++rep, d = cone.apply(d)) {
+            if (!near(d, 33.f + rep * (10.f / density))) {
+                std::fprintf(stderr, "direction check failed: density %d copy %d\n", density, rep);
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+// Single ticks with one enemy bullet and one player shot fast enough to
+// jump clean over their targets: each must hit when its path crosses the
+// target, moving or not, and miss when it passes just wide, including the
+// boss's rounded corner. All offsets are from the target's end position.
+static bool sweptHitsLand() {
+    struct Case { sf::Vector2f targetMove, from, velocity; bool hits; };
+    const Case playerCases[] = {
+        {{0.f, 0.f}, {0.f, -60.f}, {0.f, 120.f}, true},
+        {{0.f, 0.f}, {21.f, -60.f}, {0.f, 120.f}, false},
+        {{40.f, 0.f}, {-38.f, -60.f}, {0.f, 120.f}, true},
+        {{40.f, 0.f}, {-61.f, -60.f}, {0.f, 120.f}, false},
+    };
+    const Case bossCases[] = {
+        {{0.f, 0.f}, {-100.f, 0.f}, {200.f, 0.f}, true},
+        {{0.f, 0.f}, {-100.f, 46.f}, {200.f, 0.f}, false},
+        {{0.f, 100.f}, {-100.f, -50.f}, {200.f, 0.f}, true},
+        {{0.f, 0.f}, {-16.f, -104.f}, {120.f, 120.f}, false},
+    };
+    for (std::size_t c = 0; c < std::size(playerCases); ++c) {
+        const Case& pc = playerCases[c];
+        const Case& bc = bossCases[c];
+        World w(1, BulletPool::kDefaultCapacity, 30.f);
+        w.sinceHit = w.ticks(1.f);
+        w.prevPlayerPos = w.playerPos - pc.targetMove;
+        w.prevBossPos = w.bossPos - bc.targetMove;
+        w.bullets.spawnWithVelocity(w.playerPos + pc.from, pc.velocity, 5.f, sf::Color::Red);
+        w.playerBullets.spawnWithVelocity(w.bossPos + bc.from, bc.velocity, 5.f, sf::Color::Yellow);
+        w.integrateBullets();
+        w.cullBullets();
+        w.resolveCollisions();
+        if ((w.playerHealth < World::playerMaxHP) != pc.hits || (w.bossCurrentHP < World::bossMaxHP) != bc.hits) {
+            std::fprintf(stderr, "swept collision check failed: case %zu\n", c);
+            return false;
+        }
+    }
+    // A shot grazing a player hugging the left wall ends the tick wholly
+    // off screen and moving away. With shedding on it must still land.
+    World w(1, BulletPool::kDefaultCapacity, 120.f);
+    w.shedOffscreen = true;
+    w.sinceHit = w.ticks(1.f);
+    w.playerPos = w.prevPlayerPos = {World::playerRadius, 500.f};
+    w.bullets.spawnWithVelocity({22.f, 519.f}, {-32.f, 0.f}, 5.f, sf::Color::Red);
+    w.integrateBullets();
+    w.cullBullets();
+    w.resolveCollisions();
+    if (w.playerHealth == World::playerMaxHP) {
+        std::fprintf(stderr, "swept collision check failed: a shed bullet skipped its hit\n");
+        return false;
+    }
+    return true;
+}
+
+// Saves the final state and loads it into a fresh World, which must hash
+// and pack the same. Then replays the run capturing every tick, rewinds a
+// second and a half, replays the last stretch of input again and must land
+// on the same final state. The rewind half always plays the circle bot,
+// which keeps no state of its own that a rewind would have to restore.
+static bool statesRoundTrip(const RunConfig& cfg, const World& finished) {
+    std::vector<std::uint8_t> state, again;
+    std::string error;
+    World loaded = makeWorld(cfg);
+    if (!serializeWorld(finished, state, &error) || !deserializeWorld(state.data(), state.size(), loaded, &error)) {
+        std::fprintf(stderr, "state check failed: %s\n", error.c_str());
+        return false;
+    }
+    serializeWorld(loaded, again);
+    if (loaded.stateHash() != finished.stateHash() || again != state) {
+        std::fprintf(stderr, "state check failed: a loaded state differs from the saved one\n");
+        return false;
+    }
+
+    RunConfig circle = cfg;
+    circle.bot = "circle";
+    std::uint64_t expected = cfg.bot == circle.bot ? finished.stateHash() : run(circle).stateHash();
+    CircleBot bot;
+    World world = makeWorld(cfg);
+    long back = std::min<long>(world.ticks(1.5f), cfg.ticks - 1);
+    RewindBuffer rewind(static_cast<std::size_t>(world.ticks(4.f)));
+    for (long t = 0; t < cfg.ticks; ++t) {
+        world.step(bot.next(world, t));
+        if (!rewind.capture(world, &error)) break;
+    }
+    if (error.empty() && back >= 0 && cfg.ticks > 0) {
+        if (!rewind.rewind(static_cast<std::size_t>(back), world, &error)) {
+            std::fprintf(stderr, "rewind check failed: %s\n", error.c_str());
+            return false;
+        }
+        for (long t = cfg.ticks - back; t < cfg.ticks; ++t) world.step(bot.next(world, t));
+    }
+    if (!error.empty() || world.stateHash() != expected) {
+        std::fprintf(stderr, "rewind check failed: %s\n", error.empty() ? "rerun after rewinding diverged" : error.c_str());
+        return false;
+    }
+
+    // A wrapped ring holds deltas in front of its oldest keyframe; rewinding
+    // as far as reachable() allows must still work.
+    World wrapped = makeWorld(cfg);
+    RewindBuffer ring(90);
+    for (long t = 0; t < 130; ++t) {
+        wrapped.step(bot.next(wrapped, t));
+        ring.capture(wrapped);
+    }
+    if (ring.reachable() >= ring.size() || !ring.rewind(ring.reachable() - 1, wrapped, &error)) {
+        std::fprintf(stderr, "rewind check failed: %s\n", error.empty() ? "reachable() counts unreachable ticks" : error.c_str());
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    RunConfig cfg;
+    unsigned threads = 0;
+    bool check = false;
+    std::string recordPath, tracePath, loadPath, savePath;
+    std::vector<std::string> replays;
+    double minSpeed = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        if (arg == "--seed" && i + 1 < argc) cfg.seed = std::strtoull(argv[++i], nullptr, 10);
+        else if (arg == "--ticks" && i + 1 < argc) cfg.ticks = std::strtol(argv[++i], nullptr, 10);
+        else if (arg == "--tick-rate" && i + 1 < argc) cfg.tickRate = std::max(10.f, std::strtof(argv[++i], nullptr));
+        else if (arg == "--threads" && i + 1 < argc) threads = static_cast<unsigned>(std::strtoul(argv[++i], nullptr, 10));
+        else if (arg == "--density" && i + 1 < argc) cfg.density = std::max(1, static_cast<int>(std::strtol(argv[++i], nullptr, 10)));
+        else if (arg == "--patterns" && i + 1 < argc) {
+            std::string error;
+            if (!cfg.patterns.loadFile(argv[++i], &error)) {
+                std::fprintf(stderr, "%s\n", error.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--record" && i + 1 < argc) recordPath = argv[++i];
+        else if (arg == "--trace" && i + 1 < argc) tracePath = argv[++i];
+        else if (arg == "--load" && i + 1 < argc) loadPath = argv[++i];
+        else if (arg == "--save" && i + 1 < argc) savePath = argv[++i];
+        else if (arg == "--bot" && i + 1 < argc) {
+            cfg.bot = argv[++i];
+            if (!makeBot(cfg.bot)) {
+                std::fprintf(stderr, "unknown bot %s\n", cfg.bot.c_str());
+                return 2;
+            }
+        }
+        else if (arg == "--min-speed" && i + 1 < argc) minSpeed = std::strtod(argv[++i], nullptr);
+        else if (arg == "--replay" && i + 1 < argc) {
+            while (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0) replays.push_back(argv[++i]);
+        }
+        else if (arg == "--check") check = true;
+        else {
+            std::fprintf(stderr, "usage: %s [--seed N] [--ticks N] [--tick-rate HZ] [--threads N] [--density N] [--patterns FILE]\n"
+                                 "       [--record FILE] [--trace FILE] [--load FILE] [--save FILE] [--bot NAME] [--check]\n"
+                                 "       %s --replay FILE... [--min-speed X] [--threads N] [--patterns FILE]\n", argv[0], argv[0]);
+            return 2;
+        }
+    }
+    if (cfg.ticks < 0) cfg.ticks = static_cast<long>(60 * cfg.tickRate); // one minute
+
+    JobSystem jobs(threads);
+    cfg.jobs = &jobs;
+
+    if (!replays.empty()) {
+        int failures = 0;
+        for (const std::string& path : replays) failures += !playReplay(path, cfg, minSpeed);
+        return failures ? 1 : 0;
+    }
+
+    if (!loadPath.empty()) {
+        std::string error;
+        World probe = makeWorld(cfg);
+        if (!readWorldState(loadPath, cfg.startState, &error) ||
+            !deserializeWorld(cfg.startState.data(), cfg.startState.size(), probe, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+        if (!recordPath.empty()) {
+            std::fprintf(stderr, "--record cannot start from a loaded state: replays begin at the opening\n");
+            return 2;
+        }
+    }
+
+    ReplayRecorder recorder;
+    if (!recordPath.empty()) {
+        std::string error;
+        if (!recorder.open(recordPath, cfg.seed, cfg.tickRate, cfg.density, cfg.patterns, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 2;
+        }
+    }
+
+#ifdef ENABLE_PROFILER
+    if (!tracePath.empty()) Profiler::instance().startCapture();
+#else
+    if (!tracePath.empty()) {
+        std::fprintf(stderr, "--trace needs a profiler build (make PROFILE=1)\n");
+        return 2;
+    }
+#endif
+
+    std::size_t steadyAllocs = 0;
+    World world = run(cfg, &steadyAllocs, recorder.isOpen() ? &recorder : nullptr);
+#ifdef ENABLE_PROFILER
+    if (!tracePath.empty()) {
+        Profiler::instance().stopCapture();
+        std::string error;
+        if (!Profiler::instance().writeTrace(tracePath, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+#endif
+    std::uint64_t hash = world.stateHash();
+    if (recorder.isOpen()) {
+        std::string error;
+        if (!recorder.close(hash, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    if (!savePath.empty()) {
+        std::string error;
+        if (!saveWorldState(savePath, world, &error)) {
+            std::fprintf(stderr, "%s\n", error.c_str());
+            return 1;
+        }
+    }
+    long steadyTicks = std::max(1l, cfg.ticks - world.ticks(1.f));
+    std::printf("{\"seed\": %llu, \"ticks\": %ld, \"hash\": \"%016llx\", \"playerHealth\": %.1f, \"bossHP\": %.1f, "
+                "\"phase\": %d, \"threshold\": %d, \"bullets\": %zu, \"allocs_per_tick\": %.4f}\n",
+                static_cast<unsigned long long>(cfg.seed), cfg.ticks, static_cast<unsigned long long>(hash),
+                world.playerHealth, world.bossCurrentHP, world.currentPhase, world.nextThreshold, world.bullets.size(),
+                double(steadyAllocs) / steadyTicks);
+
+    if (!check) return 0;
+    if (steadyAllocs != 0) {
+        std::fprintf(stderr, "allocation check failed: %zu heap allocations after the first second\n", steadyAllocs);
+        return 1;
+    }
+    if (run(cfg).stateHash() != hash) {
+        std::fprintf(stderr, "determinism check failed: second run diverged\n");
+        return 1;
+    }
+    RunConfig opening = cfg;
+    opening.startState.clear();
+    World fresh = makeWorld(opening);
+    for (int t = fresh.ticks(1.f); t > 0; --t) fresh.step(InputFrame{});
+    if (fresh.bullets.empty()) {
+        std::fprintf(stderr, "opening check failed: no bullets a second into the fight\n");
+        return 1;
+    }
+    if (!directionsMatchTrig()) return 1;
+    if (!sweptHitsLand()) return 1;
+    if (!statesRoundTrip(cfg, world)) return 1;
+    for (KernelIsa isa : {KernelIsa::Scalar, KernelIsa::SSE2, KernelIsa::AVX2}) {
+        if (!kernelIsaSupported(isa)) continue;
+        if (!kernelMatchesScalar(isa)) return 1;
+        RunConfig other = cfg;
+        other.isa = isa;
+        if (run(other).stateHash() != hash) {
+            std::fprintf(stderr, "kernel check failed: a run using %s diverged\n", kernelIsaName(isa));
+            return 1;
+        }
+    }
+    RunConfig shed = cfg;
+    shed.shed = true;
+    World shedWorld = run(shed);
+    auto outcome = [](const World& w) {
+        return std::make_tuple(w.playerHealth, w.bossCurrentHP, w.playerPos.x, w.playerPos.y, w.bossPos.x, w.bossPos.y,
+                               w.currentPhase, w.nextThreshold, w.sinceHit, w.rng.state, w.isOver());
+    };
+    if (outcome(shedWorld) != outcome(world)) {
+        std::fprintf(stderr, "shedding check failed: a run with load shedding played out differently\n");
+        return 1;
+    }
+    for (unsigned n : {1u, 2u, 3u, 8u}) {
+        JobSystem otherJobs(n);
+        RunConfig other = cfg;
+        other.jobs = n == 1 ? nullptr : &otherJobs;
+        if (run(other).stateHash() != hash) {
+            std::fprintf(stderr, "thread check failed: a run on %u threads diverged\n", n);
+            return 1;
+        }
+    }
+    return 0;
+}